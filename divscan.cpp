@@ -0,0 +1,411 @@
+#include "divscan.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Buffers are cut into at most one chunk per worker, but never into chunks smaller than this
+const size_t MIN_CHUNK = 1 << 16;
+
+struct ScanJob {
+    int32_t divisor = 1;
+    atomic<size_t> remainingChunks{0};
+    atomic<int64_t> count{0};
+    atomic<int32_t> minElement{INT32_MAX};
+
+    // Async completion
+    divscan_callback callback = nullptr;
+    void* userData = nullptr;
+
+    // Blocking completion
+    mutex doneMutex;
+    condition_variable doneCondition;
+    bool done = false;
+};
+
+struct ChunkTask {
+    shared_ptr<ScanJob> job;
+    const int32_t* values;
+    size_t length;
+    // Arrow validity bitmap and the bit index of values[0] in it; null when every value is valid
+    const uint8_t* validity;
+    int64_t validityBit;
+};
+
+// A buffer or an Arrow chunk, before it is cut into tasks
+struct ScanSource {
+    const int32_t* values;
+    size_t length;
+    const uint8_t* validity;
+    int64_t validityBit;
+};
+
+struct divscan_scanner {
+    int32_t divisor = 1;
+    vector<thread> workers;
+
+    mutex queueMutex;
+    condition_variable queueCondition;
+    deque<ChunkTask> queue;
+    bool stopping = false;
+
+    mutex idleMutex;
+    condition_variable idleCondition;
+    size_t pendingAsync = 0;
+};
+
+static void scanChunk(const int32_t* values, size_t n, int32_t divisor, int64_t& count, int32_t& minElement) {
+    for (size_t i = 0; i < n; ++i) {
+        if (values[i] % divisor == 0) {
+            ++count;
+            minElement = min(minElement, values[i]);
+        }
+    }
+}
+
+// n <= 64 bits of bitmap starting at bit; reads only the bytes that hold them
+static uint64_t loadBits(const uint8_t* bitmap, int64_t bit, size_t n) {
+    const uint8_t* bytes = bitmap + (bit >> 3);
+    int shift = static_cast<int>(bit & 7);
+    size_t byteCount = (shift + n + 7) / 8;
+    uint64_t word = 0;
+    for (size_t i = 0; i < byteCount; ++i) {
+        int position = static_cast<int>(8 * i) - shift;
+        uint64_t byte = bytes[i];
+        word |= position >= 0 ? byte << position : byte >> -position;
+    }
+    return n == 64 ? word : word & ((1ull << n) - 1);
+}
+
+// Validity is consumed 64 values at a time: all-valid words take the plain kernel, all-null words
+// are skipped, and mixed words fold the bit into the predicate instead of branching on it
+static void scanChunkWithValidity(const int32_t* values, size_t n, const uint8_t* validity, int64_t bit,
+                                  int32_t divisor, int64_t& count, int32_t& minElement) {
+    for (size_t blockStart = 0; blockStart < n; blockStart += 64) {
+        size_t blockSize = min<size_t>(64, n - blockStart);
+        uint64_t word = loadBits(validity, bit + static_cast<int64_t>(blockStart), blockSize);
+        const int32_t* block = values + blockStart;
+        if (word == 0) {
+            continue;
+        }
+        if (blockSize == 64 ? word == ~0ull : word == (1ull << blockSize) - 1) {
+            scanChunk(block, blockSize, divisor, count, minElement);
+            continue;
+        }
+        for (size_t j = 0; j < blockSize; ++j) {
+            bool take = ((word >> j) & 1) & (block[j] % divisor == 0);
+            count += take;
+            minElement = min(minElement, take ? block[j] : INT32_MAX);
+        }
+    }
+}
+
+static void finishJob(divscan_scanner* scanner, ScanJob& job) {
+    if (job.callback != nullptr) {
+        divscan_result result{job.count.load(), job.minElement.load(), DIVSCAN_OK};
+        job.callback(&result, job.userData);
+        lock_guard lock(scanner->idleMutex);
+        if (--scanner->pendingAsync == 0) {
+            scanner->idleCondition.notify_all();
+        }
+        return;
+    }
+    lock_guard lock(job.doneMutex);
+    job.done = true;
+    job.doneCondition.notify_all();
+}
+
+// Same merge as findDivisibleWithAtomic: fetch_add for the count, CAS loop for the minimum
+static void runChunk(divscan_scanner* scanner, const ChunkTask& task) {
+    ScanJob& job = *task.job;
+    int64_t localCount = 0;
+    int32_t localMin = INT32_MAX;
+    if (task.validity == nullptr) {
+        scanChunk(task.values, task.length, job.divisor, localCount, localMin);
+    } else {
+        scanChunkWithValidity(task.values, task.length, task.validity, task.validityBit, job.divisor,
+                              localCount, localMin);
+    }
+
+    job.count.fetch_add(localCount);
+    int32_t currentMin = job.minElement.load();
+    while (localMin < currentMin && !job.minElement.compare_exchange_weak(currentMin, localMin)) {
+    }
+
+    if (job.remainingChunks.fetch_sub(1) == 1) {
+        finishJob(scanner, job);
+    }
+}
+
+static void workerLoop(divscan_scanner* scanner) {
+    while (true) {
+        ChunkTask task;
+        {
+            unique_lock lock(scanner->queueMutex);
+            scanner->queueCondition.wait(lock, [&] { return scanner->stopping || !scanner->queue.empty(); });
+            if (scanner->queue.empty()) {
+                return;
+            }
+            task = std::move(scanner->queue.front());
+            scanner->queue.pop_front();
+        }
+        runChunk(scanner, task);
+    }
+}
+
+static void startWorkers(divscan_scanner* scanner, int32_t numThreads) {
+    if (numThreads <= 0) {
+        numThreads = static_cast<int32_t>(max(1u, thread::hardware_concurrency()));
+    }
+    scanner->stopping = false;
+    for (int32_t i = 0; i < numThreads; ++i) {
+        scanner->workers.emplace_back(workerLoop, scanner);
+    }
+}
+
+static void stopWorkers(divscan_scanner* scanner) {
+    {
+        lock_guard lock(scanner->queueMutex);
+        scanner->stopping = true;
+    }
+    scanner->queueCondition.notify_all();
+    for (auto& worker : scanner->workers) {
+        worker.join();
+    }
+    scanner->workers.clear();
+}
+
+static size_t chunkCount(const divscan_scanner* scanner, size_t length) {
+    return max<size_t>(1, min(scanner->workers.size(), length / MIN_CHUNK));
+}
+
+// Every source is cut separately; the job completes when the last task of the last source finishes
+static void submit(divscan_scanner* scanner, const shared_ptr<ScanJob>& job, const vector<ScanSource>& sources) {
+    size_t totalChunks = 0;
+    for (const auto& source : sources) {
+        totalChunks += chunkCount(scanner, source.length);
+    }
+    job->remainingChunks.store(totalChunks);
+    {
+        lock_guard lock(scanner->queueMutex);
+        // Workers cannot take tasks while the lock is held, so a failed push removes the job's tasks again
+        size_t pushed = 0;
+        try {
+            for (const auto& source : sources) {
+                size_t chunks = chunkCount(scanner, source.length);
+                size_t chunkSize = source.length / chunks;
+                for (size_t i = 0; i < chunks; ++i) {
+                    size_t start = i * chunkSize;
+                    size_t end = (i == chunks - 1) ? source.length : start + chunkSize;
+                    scanner->queue.push_back({job, source.values + start, end - start, source.validity,
+                                              source.validityBit + static_cast<int64_t>(start)});
+                    ++pushed;
+                }
+            }
+        } catch (...) {
+            for (; pushed > 0; --pushed) {
+                scanner->queue.pop_back();
+            }
+            throw;
+        }
+    }
+    scanner->queueCondition.notify_all();
+}
+
+// Exceptions must not cross the C ABI; failures become status codes
+static int statusOf(const exception_ptr& error) {
+    try {
+        rethrow_exception(error);
+    } catch (const bad_alloc&) {
+        return DIVSCAN_OUT_OF_MEMORY;
+    } catch (...) {
+        return DIVSCAN_SYSTEM_ERROR;
+    }
+}
+
+// Cuts the chunks of an int32 Arrow array into scan sources; all-null and empty chunks are dropped
+static int collectArrowSources(const ArrowSchema* schema, const ArrowArray* const* chunks, size_t num_chunks,
+                               vector<ScanSource>& sources) {
+    if (schema->format == nullptr || string_view(schema->format) != "i" || schema->dictionary != nullptr) {
+        return DIVSCAN_UNSUPPORTED_TYPE;
+    }
+    for (size_t i = 0; i < num_chunks; ++i) {
+        const ArrowArray* array = chunks[i];
+        if (array == nullptr || array->release == nullptr || array->n_buffers != 2 || array->buffers == nullptr ||
+            array->length < 0 || array->offset < 0) {
+            return DIVSCAN_INVALID_ARGUMENT;
+        }
+        // All-null chunks contribute nothing, so their buffers are never read
+        if (array->length == 0 || array->null_count == array->length) {
+            continue;
+        }
+        if (array->buffers[1] == nullptr) {
+            return DIVSCAN_INVALID_ARGUMENT;
+        }
+        const auto* values = static_cast<const int32_t*>(array->buffers[1]) + array->offset;
+        // A bitmap may be absent, or present but irrelevant when null_count is known to be 0
+        const auto* validity = array->null_count == 0 ? nullptr : static_cast<const uint8_t*>(array->buffers[0]);
+        sources.push_back({values, static_cast<size_t>(array->length), validity, array->offset});
+    }
+    return DIVSCAN_OK;
+}
+
+static int runBlocking(divscan_scanner* scanner, const vector<ScanSource>& sources, divscan_result* result) {
+    if (scanner->workers.empty()) {
+        return DIVSCAN_SYSTEM_ERROR;
+    }
+    auto job = make_shared<ScanJob>();
+    job->divisor = scanner->divisor;
+    submit(scanner, job, sources);
+
+    unique_lock lock(job->doneMutex);
+    job->doneCondition.wait(lock, [&] { return job->done; });
+    result->count = job->count.load();
+    result->min_element = job->minElement.load();
+    return DIVSCAN_OK;
+}
+
+extern "C" {
+
+divscan_scanner* divscan_create(int32_t divisor, int32_t num_threads) {
+    // The remainder test only depends on |divisor|; INT32_MIN has no positive counterpart
+    if (divisor == 0 || divisor == INT32_MIN) {
+        return nullptr;
+    }
+    auto* scanner = new (nothrow) divscan_scanner;
+    if (scanner == nullptr) {
+        return nullptr;
+    }
+    scanner->divisor = divisor < 0 ? -divisor : divisor;
+    try {
+        startWorkers(scanner, num_threads);
+    } catch (...) {
+        // Joins whichever workers did start
+        stopWorkers(scanner);
+        delete scanner;
+        return nullptr;
+    }
+    return scanner;
+}
+
+void divscan_destroy(divscan_scanner* scanner) {
+    if (scanner == nullptr) {
+        return;
+    }
+    divscan_wait(scanner);
+    stopWorkers(scanner);
+    delete scanner;
+}
+
+int divscan_set_threads(divscan_scanner* scanner, int32_t num_threads) {
+    if (scanner == nullptr) {
+        return DIVSCAN_INVALID_ARGUMENT;
+    }
+    divscan_wait(scanner);
+    stopWorkers(scanner);
+    try {
+        startWorkers(scanner, num_threads);
+    } catch (...) {
+        int status = statusOf(current_exception());
+        stopWorkers(scanner);
+        return status;
+    }
+    return DIVSCAN_OK;
+}
+
+int32_t divscan_get_threads(const divscan_scanner* scanner) {
+    return scanner == nullptr ? 0 : static_cast<int32_t>(scanner->workers.size());
+}
+
+int divscan_scan(divscan_scanner* scanner, const int32_t* values, size_t length, divscan_result* result) {
+    if (scanner == nullptr || result == nullptr || (values == nullptr && length > 0)) {
+        return DIVSCAN_INVALID_ARGUMENT;
+    }
+    *result = {0, INT32_MAX, DIVSCAN_OK};
+    if (length == 0) {
+        return DIVSCAN_OK;
+    }
+    try {
+        result->status = runBlocking(scanner, {{values, length, nullptr, 0}}, result);
+    } catch (...) {
+        result->status = statusOf(current_exception());
+    }
+    return result->status;
+}
+
+int divscan_scan_async(divscan_scanner* scanner, const int32_t* values, size_t length,
+                       divscan_callback callback, void* user_data) {
+    if (scanner == nullptr || callback == nullptr || (values == nullptr && length > 0)) {
+        return DIVSCAN_INVALID_ARGUMENT;
+    }
+    // An empty buffer still becomes one zero-length task, so the callback never runs on the caller's thread
+    if (scanner->workers.empty()) {
+        return DIVSCAN_SYSTEM_ERROR;
+    }
+
+    bool counted = false;
+    try {
+        auto job = make_shared<ScanJob>();
+        job->divisor = scanner->divisor;
+        job->callback = callback;
+        job->userData = user_data;
+        {
+            lock_guard lock(scanner->idleMutex);
+            ++scanner->pendingAsync;
+            counted = true;
+        }
+        submit(scanner, job, {{values, length, nullptr, 0}});
+    } catch (...) {
+        // Nothing was queued, so the callback never runs and the scan must not count as pending
+        if (counted) {
+            lock_guard lock(scanner->idleMutex);
+            if (--scanner->pendingAsync == 0) {
+                scanner->idleCondition.notify_all();
+            }
+        }
+        return statusOf(current_exception());
+    }
+    return DIVSCAN_OK;
+}
+
+int divscan_scan_arrow(divscan_scanner* scanner, const struct ArrowSchema* schema,
+                       const struct ArrowArray* const* chunks, size_t num_chunks, divscan_result* result) {
+    if (scanner == nullptr || schema == nullptr || result == nullptr || (chunks == nullptr && num_chunks > 0)) {
+        return DIVSCAN_INVALID_ARGUMENT;
+    }
+    *result = {0, INT32_MAX, DIVSCAN_OK};
+    try {
+        vector<ScanSource> sources;
+        result->status = collectArrowSources(schema, chunks, num_chunks, sources);
+        if (result->status == DIVSCAN_OK && !sources.empty()) {
+            result->status = runBlocking(scanner, sources, result);
+        }
+    } catch (...) {
+        result->status = statusOf(current_exception());
+    }
+    return result->status;
+}
+
+void divscan_wait(divscan_scanner* scanner) {
+    if (scanner == nullptr) {
+        return;
+    }
+    unique_lock lock(scanner->idleMutex);
+    scanner->idleCondition.wait(lock, [&] { return scanner->pendingAsync == 0; });
+}
+
+const char* divscan_version(void) {
+    return "1.0.0";
+}
+
+}
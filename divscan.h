@@ -0,0 +1,113 @@
+#ifndef DIVSCAN_H
+#define DIVSCAN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#define DIVSCAN_API __declspec(dllexport)
+#else
+#define DIVSCAN_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Stable C ABI of libdivscan: count and minimum of the values divisible by a divisor,
+   scanned in parallel directly over caller-owned buffers. */
+
+#define DIVSCAN_OK 0
+#define DIVSCAN_INVALID_ARGUMENT (-1)
+#define DIVSCAN_OUT_OF_MEMORY (-2)
+#define DIVSCAN_UNSUPPORTED_TYPE (-3)
+/* A worker thread could not be started, or the scanner has no workers after such a failure */
+#define DIVSCAN_SYSTEM_ERROR (-4)
+
+typedef struct divscan_scanner divscan_scanner;
+
+/* Arrow C Data Interface, copied verbatim from the specification so no Arrow dependency is needed */
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+    void (*release)(struct ArrowSchema*);
+    void* private_data;
+};
+
+struct ArrowArray {
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+    void (*release)(struct ArrowArray*);
+    void* private_data;
+};
+
+#endif
+
+typedef struct divscan_result {
+    int64_t count;
+    /* INT32_MAX when nothing was divisible */
+    int32_t min_element;
+    int32_t status;
+} divscan_result;
+
+/* Runs on a pool thread once an async scan finished; must not call divscan_destroy,
+   divscan_set_threads, divscan_wait or the blocking divscan_scan */
+typedef void (*divscan_callback)(const divscan_result* result, void* user_data);
+
+/* num_threads <= 0 uses the number of hardware threads. Returns NULL on an invalid divisor or when
+   the scanner or its threads cannot be created. */
+DIVSCAN_API divscan_scanner* divscan_create(int32_t divisor, int32_t num_threads);
+
+/* Waits for outstanding async scans, then stops the pool */
+DIVSCAN_API void divscan_destroy(divscan_scanner* scanner);
+
+/* Waits for outstanding async scans, then resizes the pool; must not run concurrently with
+   other calls on the same scanner. On failure the scanner is left without workers and scans return
+   DIVSCAN_SYSTEM_ERROR until a later call succeeds. */
+DIVSCAN_API int divscan_set_threads(divscan_scanner* scanner, int32_t num_threads);
+
+DIVSCAN_API int32_t divscan_get_threads(const divscan_scanner* scanner);
+
+/* Blocking scan; values are read in place and never copied */
+DIVSCAN_API int divscan_scan(divscan_scanner* scanner, const int32_t* values, size_t length,
+                             divscan_result* result);
+
+/* Returns immediately; values must stay valid until callback ran */
+DIVSCAN_API int divscan_scan_async(divscan_scanner* scanner, const int32_t* values, size_t length,
+                                   divscan_callback callback, void* user_data);
+
+/* Blocking scan over the chunks of an int32 ("i") Arrow array, e.g. the chunks of a ChunkedArray,
+   all described by schema. Nulls are skipped using the validity bitmap; buffers are read in place
+   and ownership stays with the caller (release callbacks are not invoked). */
+DIVSCAN_API int divscan_scan_arrow(divscan_scanner* scanner, const struct ArrowSchema* schema,
+                                   const struct ArrowArray* const* chunks, size_t num_chunks,
+                                   divscan_result* result);
+
+/* Blocks until every async scan submitted so far completed */
+DIVSCAN_API void divscan_wait(divscan_scanner* scanner);
+
+DIVSCAN_API const char* divscan_version(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,293 @@
+// CPython extension over libdivscan: scans any buffer-protocol object of 32-bit ints
+// (NumPy int32 arrays, array.array('i'), memoryview) in place, with the GIL released
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <shared_mutex>
+
+#include "divscan.h"
+
+// Readers-writer lock that prefers writers: once a resize waits, new scans queue behind it, so Python
+// threads scanning back to back cannot starve it (glibc's rwlock, behind std::shared_mutex, can)
+class ScanGate {
+public:
+    void lock_shared() {
+        std::unique_lock guard(mutex);
+        changed.wait(guard, [&] { return !writing && writersWaiting == 0; });
+        ++readers;
+    }
+
+    void unlock_shared() {
+        std::lock_guard guard(mutex);
+        if (--readers == 0) {
+            changed.notify_all();
+        }
+    }
+
+    void lock() {
+        std::unique_lock guard(mutex);
+        ++writersWaiting;
+        changed.wait(guard, [&] { return !writing && readers == 0; });
+        --writersWaiting;
+        writing = true;
+    }
+
+    void unlock() {
+        std::lock_guard guard(mutex);
+        writing = false;
+        changed.notify_all();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable changed;
+    int readers = 0;
+    int writersWaiting = 0;
+    bool writing = false;
+};
+
+// Scans hold gate shared; resizing and re-initialising hold it exclusively, since libdivscan forbids
+// running those concurrently with scans. It is only ever taken with the GIL released, so a scan
+// waiting for the GIL while holding it cannot deadlock against a writer.
+struct ScannerObject {
+    PyObject_HEAD
+    divscan_scanner* scanner;
+    ScanGate gate;
+};
+
+// Accepts C-contiguous buffers of native 4-byte signed integers only, so no conversion copy is needed
+static bool isInt32Format(const Py_buffer& view) {
+    if (view.itemsize != 4 || view.format == nullptr) {
+        return false;
+    }
+    const char* format = view.format;
+    if (*format == '@' || *format == '=' || *format == (PY_LITTLE_ENDIAN ? '<' : '>')) {
+        ++format;
+    }
+    return std::strcmp(format, "i") == 0 || std::strcmp(format, "l") == 0;
+}
+
+static PyObject* resultToTuple(const divscan_result& result) {
+    if (result.count == 0) {
+        return Py_BuildValue("(LO)", static_cast<long long>(result.count), Py_None);
+    }
+    return Py_BuildValue("(Li)", static_cast<long long>(result.count), result.min_element);
+}
+
+// owner, when given, supplies the scanner under its gate; otherwise scanner is private to the caller
+static PyObject* scanBuffer(divscan_scanner* scanner, ScannerObject* owner, PyObject* data) {
+    Py_buffer view;
+    if (PyObject_GetBuffer(data, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0) {
+        return nullptr;
+    }
+    if (!isInt32Format(view)) {
+        PyErr_Format(PyExc_TypeError, "expected a contiguous buffer of int32, got format '%s' with itemsize %zd",
+                     view.format == nullptr ? "" : view.format, view.itemsize);
+        PyBuffer_Release(&view);
+        return nullptr;
+    }
+
+    divscan_result result;
+    int status;
+    // The buffer export pins the memory, so other Python threads may run while we scan it
+    Py_BEGIN_ALLOW_THREADS
+    {
+        std::shared_lock<ScanGate> guard;
+        if (owner != nullptr) {
+            guard = std::shared_lock(owner->gate);
+            scanner = owner->scanner;
+        }
+        status = divscan_scan(scanner, static_cast<const int32_t*>(view.buf),
+                              static_cast<size_t>(view.len / view.itemsize), &result);
+    }
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&view);
+
+    if (status != DIVSCAN_OK) {
+        PyErr_Format(PyExc_RuntimeError, "divscan_scan failed with status %d", status);
+        return nullptr;
+    }
+    return resultToTuple(result);
+}
+
+static int Scanner_init(ScannerObject* self, PyObject* args, PyObject* kwargs) {
+    static const char* keywords[] = {"divisor", "threads", nullptr};
+    int divisor = 19;
+    int threads = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|ii", const_cast<char**>(keywords), &divisor, &threads)) {
+        return -1;
+    }
+    divscan_scanner* scanner = divscan_create(divisor, threads);
+    if (scanner == nullptr) {
+        PyErr_SetString(PyExc_ValueError, "invalid divisor");
+        return -1;
+    }
+    // Re-calling __init__ swaps the scanner only once scans already running on the old one finished
+    divscan_scanner* previous;
+    Py_BEGIN_ALLOW_THREADS
+    {
+        std::unique_lock guard(self->gate);
+        previous = self->scanner;
+        self->scanner = scanner;
+    }
+    if (previous != nullptr) {
+        divscan_destroy(previous);
+    }
+    Py_END_ALLOW_THREADS
+    return 0;
+}
+
+static PyObject* Scanner_new(PyTypeObject* type, PyObject*, PyObject*) {
+    auto* self = reinterpret_cast<ScannerObject*>(type->tp_alloc(type, 0));
+    if (self != nullptr) {
+        self->scanner = nullptr;
+        new (&self->gate) ScanGate;
+    }
+    return reinterpret_cast<PyObject*>(self);
+}
+
+static void Scanner_dealloc(ScannerObject* self) {
+    if (self->scanner != nullptr) {
+        Py_BEGIN_ALLOW_THREADS
+        divscan_destroy(self->scanner);
+        Py_END_ALLOW_THREADS
+    }
+    self->gate.~ScanGate();
+    // Heap types own a reference from each instance
+    PyTypeObject* type = Py_TYPE(self);
+    type->tp_free(reinterpret_cast<PyObject*>(self));
+    Py_DECREF(type);
+}
+
+static bool checkInitialized(const ScannerObject* self) {
+    if (self->scanner == nullptr) {
+        PyErr_SetString(PyExc_RuntimeError, "Scanner.__init__ was not called");
+        return false;
+    }
+    return true;
+}
+
+static PyObject* Scanner_scan(ScannerObject* self, PyObject* data) {
+    if (!checkInitialized(self)) {
+        return nullptr;
+    }
+    return scanBuffer(nullptr, self, data);
+}
+
+static PyObject* Scanner_get_threads(ScannerObject* self, void*) {
+    if (!checkInitialized(self)) {
+        return nullptr;
+    }
+    int32_t threads;
+    Py_BEGIN_ALLOW_THREADS
+    {
+        std::shared_lock guard(self->gate);
+        threads = divscan_get_threads(self->scanner);
+    }
+    Py_END_ALLOW_THREADS
+    return PyLong_FromLong(threads);
+}
+
+static int Scanner_set_threads(ScannerObject* self, PyObject* value, void*) {
+    if (value == nullptr) {
+        PyErr_SetString(PyExc_AttributeError, "cannot delete threads");
+        return -1;
+    }
+    if (!checkInitialized(self)) {
+        return -1;
+    }
+    long threads = PyLong_AsLong(value);
+    if (threads == -1 && PyErr_Occurred()) {
+        return -1;
+    }
+    int status;
+    Py_BEGIN_ALLOW_THREADS
+    {
+        std::unique_lock guard(self->gate);
+        status = divscan_set_threads(self->scanner, static_cast<int32_t>(threads));
+    }
+    Py_END_ALLOW_THREADS
+    if (status != DIVSCAN_OK) {
+        PyErr_Format(PyExc_RuntimeError, "divscan_set_threads failed with status %d", status);
+        return -1;
+    }
+    return 0;
+}
+
+static PyMethodDef Scanner_methods[] = {
+    {"scan", reinterpret_cast<PyCFunction>(Scanner_scan), METH_O,
+     "scan(buffer) -> (count, minimum or None) over an int32 buffer, without copying"},
+    {nullptr, nullptr, 0, nullptr},
+};
+
+static PyGetSetDef Scanner_getset[] = {
+    {"threads", reinterpret_cast<getter>(Scanner_get_threads), reinterpret_cast<setter>(Scanner_set_threads),
+     "number of pool threads", nullptr},
+    {nullptr, nullptr, nullptr, nullptr, nullptr},
+};
+
+static PyType_Slot Scanner_slots[] = {
+    {Py_tp_doc, const_cast<char*>("Scanner(divisor=19, threads=0): reusable scanner with its own thread pool")},
+    {Py_tp_new, reinterpret_cast<void*>(Scanner_new)},
+    {Py_tp_init, reinterpret_cast<void*>(Scanner_init)},
+    {Py_tp_dealloc, reinterpret_cast<void*>(Scanner_dealloc)},
+    {Py_tp_methods, Scanner_methods},
+    {Py_tp_getset, Scanner_getset},
+    {0, nullptr},
+};
+
+static PyType_Spec Scanner_spec = {
+    "divscan.Scanner", sizeof(ScannerObject), 0, Py_TPFLAGS_DEFAULT, Scanner_slots,
+};
+
+static PyObject* module_scan(PyObject*, PyObject* args, PyObject* kwargs) {
+    static const char* keywords[] = {"buffer", "divisor", "threads", nullptr};
+    PyObject* data;
+    int divisor = 19;
+    int threads = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|ii", const_cast<char**>(keywords), &data, &divisor,
+                                     &threads)) {
+        return nullptr;
+    }
+    divscan_scanner* scanner = divscan_create(divisor, threads);
+    if (scanner == nullptr) {
+        PyErr_SetString(PyExc_ValueError, "invalid divisor");
+        return nullptr;
+    }
+    PyObject* result = scanBuffer(scanner, nullptr, data);
+    Py_BEGIN_ALLOW_THREADS
+    divscan_destroy(scanner);
+    Py_END_ALLOW_THREADS
+    return result;
+}
+
+static PyMethodDef module_methods[] = {
+    {"scan", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)(void)>(module_scan)),
+     METH_VARARGS | METH_KEYWORDS,
+     "scan(buffer, divisor=19, threads=0) -> (count, minimum or None) with a one-off scanner"},
+    {nullptr, nullptr, 0, nullptr},
+};
+
+static PyModuleDef divscan_module = {
+    PyModuleDef_HEAD_INIT, "divscan", "Parallel divisibility scans over int32 buffers.", -1, module_methods,
+    nullptr, nullptr, nullptr, nullptr,
+};
+
+PyMODINIT_FUNC PyInit_divscan(void) {
+    PyObject* module = PyModule_Create(&divscan_module);
+    if (module == nullptr) {
+        return nullptr;
+    }
+    PyObject* scannerType = PyType_FromSpec(&Scanner_spec);
+    if (scannerType == nullptr || PyModule_AddObject(module, "Scanner", scannerType) < 0) {
+        Py_XDECREF(scannerType);
+        Py_DECREF(module);
+        return nullptr;
+    }
+    PyModule_AddStringConstant(module, "__version__", divscan_version());
+    return module;
+}
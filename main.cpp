@@ -6,30 +6,267 @@
 #include <mutex>
 #include <chrono>
 #include <algorithm>
+#include <climits>
+#include <shared_mutex>
+#include <condition_variable>
+#include <functional>
+#include <string>
+#include <memory>
+#include <cmath>
+#include <cstdint>
+#include <array>
+#include <utility>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <cstdio>
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <linux/aio_abi.h>
+// linux/fs.h, pulled in by aio_abi.h, defines a BLOCK_SIZE macro that clashes with ours
+#undef BLOCK_SIZE
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+#if defined(DIVSCAN_USDT)
+#include <sys/sdt.h>
+#endif
 
 using namespace std;
 
+// USDT probes (provider "divscan") for bpftrace; compiled in with -DDIVSCAN_USDT=ON, a single nop each
+#if defined(DIVSCAN_USDT)
+#define DIVSCAN_PROBE(...) STAP_PROBEV(divscan, __VA_ARGS__)
+#else
+#define DIVSCAN_PROBE(...) do { } while (0)
+#endif
+
 const int DATA_SIZE = 1000000000;
 const int NUM_THREADS = 1;
 const int DIVISOR = 19;
 
 // Data generation
-vector<int> generateData(int size) {
+const int MAX_VALUE = 99999;
+
+enum class Distribution {
+    Uniform,
+    Sorted,
+    ReverseSorted,
+    Zipf,
+    AllDivisible,
+    NoneDivisible,
+    Clustered,
+    Selectivity
+};
+
+const vector<pair<string, Distribution>> DISTRIBUTIONS = {
+    {"uniform", Distribution::Uniform},
+    {"sorted", Distribution::Sorted},
+    {"reverse-sorted", Distribution::ReverseSorted},
+    {"zipf", Distribution::Zipf},
+    {"all-divisible", Distribution::AllDivisible},
+    {"none-divisible", Distribution::NoneDivisible},
+    {"clustered", Distribution::Clustered},
+    {"selectivity", Distribution::Selectivity},
+};
+
+struct GeneratorOptions {
+    Distribution distribution = Distribution::Uniform;
+    // Fraction of divisible elements for Selectivity and Clustered
+    double selectivity = 0.05;
+    // Clustered puts all divisible elements into the last of this many equal chunks
+    int chunks = NUM_THREADS;
+    double zipfExponent = 1.1;
+};
+
+bool parseDistribution(const string& name, Distribution& distribution) {
+    for (const auto& [candidate, value] : DISTRIBUTIONS) {
+        if (candidate == name) {
+            distribution = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+int randomDivisible(mt19937& gen) {
+    uniform_int_distribution dist(0, MAX_VALUE / DIVISOR);
+    return dist(gen) * DIVISOR;
+}
+
+int randomNonDivisible(mt19937& gen) {
+    uniform_int_distribution quotient(0, (MAX_VALUE - (DIVISOR - 1)) / DIVISOR);
+    uniform_int_distribution remainder(1, DIVISOR - 1);
+    return quotient(gen) * DIVISOR + remainder(gen);
+}
+
+vector<int> generateData(int size, const GeneratorOptions& options = {}) {
     vector<int> data(size);
 
     random_device rd;
     mt19937 gen(rd());
-    uniform_int_distribution dist(0, 99999);
+    uniform_int_distribution dist(0, MAX_VALUE);
 
-    for (int i = 0; i < size; ++i) {
-        data[i] = dist(gen);
+    switch (options.distribution) {
+        case Distribution::Uniform:
+        case Distribution::Sorted:
+        case Distribution::ReverseSorted:
+            for (int i = 0; i < size; ++i) {
+                data[i] = dist(gen);
+            }
+            if (options.distribution == Distribution::Sorted) {
+                sort(data.begin(), data.end());
+            } else if (options.distribution == Distribution::ReverseSorted) {
+                sort(data.begin(), data.end(), greater());
+            }
+            break;
+        case Distribution::Zipf: {
+            // Value v has weight 1 / (v + 1)^s, so small values dominate
+            vector<double> weights(MAX_VALUE + 1);
+            for (int v = 0; v <= MAX_VALUE; ++v) {
+                weights[v] = 1.0 / pow(v + 1.0, options.zipfExponent);
+            }
+            discrete_distribution zipf(weights.begin(), weights.end());
+            for (int i = 0; i < size; ++i) {
+                data[i] = zipf(gen);
+            }
+            break;
+        }
+        case Distribution::AllDivisible:
+            for (int i = 0; i < size; ++i) {
+                data[i] = randomDivisible(gen);
+            }
+            break;
+        case Distribution::NoneDivisible:
+            for (int i = 0; i < size; ++i) {
+                data[i] = randomNonDivisible(gen);
+            }
+            break;
+        case Distribution::Selectivity: {
+            bernoulli_distribution pick(options.selectivity);
+            for (int i = 0; i < size; ++i) {
+                data[i] = pick(gen) ? randomDivisible(gen) : randomNonDivisible(gen);
+            }
+            break;
+        }
+        case Distribution::Clustered: {
+            int chunks = max(1, options.chunks);
+            int clusterStart = size / chunks * (chunks - 1);
+            int clusterSize = size - clusterStart;
+            double matches = min<double>(clusterSize, options.selectivity * size);
+            bernoulli_distribution pick(clusterSize > 0 ? matches / clusterSize : 0);
+            for (int i = 0; i < size; ++i) {
+                data[i] = i >= clusterStart && pick(gen) ? randomDivisible(gen) : randomNonDivisible(gen);
+            }
+            break;
+        }
     }
 
     return data;
 }
 
+// Per-thread timeline tracing in Chrome trace-event format
+bool tracingEnabled = false;
+
+struct TraceEvent {
+    const char* name;
+    uint64_t startNs;
+    uint64_t durationNs;
+    const char* argName;
+    long long argValue;
+};
+
+struct TraceBuffer {
+    int tid;
+    vector<TraceEvent> events;
+};
+
+// Buffers outlive their threads so short-lived workers can still be dumped after join
+mutex traceRegistryMutex;
+vector<unique_ptr<TraceBuffer>> traceRegistry;
+const auto TRACE_EPOCH = chrono::steady_clock::now();
+
+uint64_t traceNow() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - TRACE_EPOCH).count();
+}
+
+TraceBuffer& threadTraceBuffer() {
+    thread_local TraceBuffer* buffer = nullptr;
+    if (buffer == nullptr) {
+        lock_guard lock(traceRegistryMutex);
+        traceRegistry.push_back(make_unique<TraceBuffer>());
+        buffer = traceRegistry.back().get();
+        buffer->tid = static_cast<int>(traceRegistry.size());
+        buffer->events.reserve(1024);
+    }
+    return *buffer;
+}
+
+// Records one complete ("X") event from construction to end() or destruction; free when tracing is off
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name) : name(name), start(tracingEnabled ? traceNow() : 0) {}
+
+    ~TraceSpan() { end(); }
+
+    void setArg(const char* argName, long long value) {
+        this->argName = argName;
+        argValue = value;
+    }
+
+    void end() {
+        if (!tracingEnabled || ended) {
+            return;
+        }
+        ended = true;
+        threadTraceBuffer().events.push_back({name, start, traceNow() - start, argName, argValue});
+    }
+
+private:
+    const char* name;
+    uint64_t start;
+    const char* argName = nullptr;
+    long long argValue = 0;
+    bool ended = false;
+};
+
+bool writeChromeTrace(const string& path) {
+    ofstream file(path);
+    lock_guard lock(traceRegistryMutex);
+    file << fixed << setprecision(3);
+    file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& buffer : traceRegistry) {
+        for (const auto& event : buffer->events) {
+            file << (first ? "\n" : ",\n") << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+                 << buffer->tid << ",\"ts\":" << event.startNs / 1000.0 << ",\"dur\":" << event.durationNs / 1000.0;
+            if (event.argName != nullptr) {
+                file << ",\"args\":{\"" << event.argName << "\":" << event.argValue << "}";
+            }
+            file << "}";
+            first = false;
+        }
+    }
+    file << "\n]}\n";
+    return static_cast<bool>(file);
+}
+
 // Without parallelization
 void findDivisibleWithoutParallel(const vector<int>& data, int& count, int& minElement) {
+    DIVSCAN_PROBE(scan__start, "sequential", data.size());
     count = 0;
     minElement = INT_MAX;
     for (const auto value : data) {
@@ -38,16 +275,71 @@ void findDivisibleWithoutParallel(const vector<int>& data, int& count, int& minE
             minElement = min(minElement, value);
         }
     }
+    DIVSCAN_PROBE(scan__end, "sequential", count, minElement);
+}
+
+// Per-thread accounting for the parallel strategies
+struct ThreadStats {
+    double busySeconds = 0;
+    double syncSeconds = 0;
+    long long elements = 0;
+};
+
+struct ParallelReport {
+    vector<ThreadStats> threads;
+    double wallSeconds = 0;
+
+    double meanBusy() const {
+        double total = 0;
+        for (const auto& stats : threads) {
+            total += stats.busySeconds;
+        }
+        return threads.empty() ? 0 : total / threads.size();
+    }
+
+    double maxBusy() const {
+        double result = 0;
+        for (const auto& stats : threads) {
+            result = max(result, stats.busySeconds);
+        }
+        return result;
+    }
+
+    // max / mean busy time; 1.0 means perfectly balanced
+    double imbalance() const {
+        double mean = meanBusy();
+        return mean > 0 ? maxBusy() / mean : 1.0;
+    }
+
+    // Longest busy + sync path of any thread; the rest of the wall time is spawn and join
+    double criticalPath() const {
+        double result = 0;
+        for (const auto& stats : threads) {
+            result = max(result, stats.busySeconds + stats.syncSeconds);
+        }
+        return result;
+    }
+};
+
+double secondsBetween(chrono::steady_clock::time_point start, chrono::steady_clock::time_point end) {
+    return chrono::duration<double>(end - start).count();
 }
 
 // With blocking primitives
-void findDivisibleWithMutex(const vector<int>& data, int& count, int& minElement) {
+void findDivisibleWithMutex(const vector<int>& data, int& count, int& minElement, ParallelReport* report = nullptr) {
+    DIVSCAN_PROBE(scan__start, "mutex", data.size());
     mutex mtx;
     count = 0;
     minElement = INT_MAX;
     vector<thread> threads;
+    vector<ThreadStats> stats(NUM_THREADS);
+    auto wallStart = chrono::steady_clock::now();
 
-    auto task = [&](int start, int end) {
+    auto task = [&](int index, int start, int end) {
+        DIVSCAN_PROBE(chunk__start, index, start, end);
+        TraceSpan chunkSpan("chunk");
+        chunkSpan.setArg("elements", end - start);
+        auto busyStart = chrono::steady_clock::now();
         int localCount = 0;
         int localMin = INT_MAX;
         for (int i = start; i < end; ++i) {
@@ -56,92 +348,3335 @@ void findDivisibleWithMutex(const vector<int>& data, int& count, int& minElement
                 localMin = min(localMin, data[i]);
             }
         }
+        auto waitStart = chrono::steady_clock::now();
+        chunkSpan.end();
+        DIVSCAN_PROBE(chunk__end, index, localCount, localMin);
+
+        TraceSpan waitSpan("lock wait");
+        DIVSCAN_PROBE(mutex__wait, index);
         lock_guard lock(mtx);
+        auto waitEnd = chrono::steady_clock::now();
+        waitSpan.end();
         count += localCount;
         minElement = min(minElement, localMin);
+        DIVSCAN_PROBE(mutex__merge, index, localCount, localMin);
+        stats[index] = {secondsBetween(busyStart, waitStart), secondsBetween(waitStart, waitEnd), end - start};
     };
 
-    const int chunkSize = DATA_SIZE / NUM_THREADS;
+    TraceSpan spawnSpan("spawn");
+    const int size = static_cast<int>(data.size());
+    const int chunkSize = size / NUM_THREADS;
     for (int i = 0; i < NUM_THREADS; ++i) {
         int start = i * chunkSize;
-        int end = (i == NUM_THREADS - 1) ? DATA_SIZE : start + chunkSize;
-        threads.emplace_back(task, start, end);
+        int end = (i == NUM_THREADS - 1) ? size : start + chunkSize;
+        threads.emplace_back(task, i, start, end);
     }
+    spawnSpan.end();
 
+    TraceSpan joinSpan("join");
     for (auto& thread : threads) {
         thread.join();
     }
+    DIVSCAN_PROBE(scan__end, "mutex", count, minElement);
+
+    if (report != nullptr) {
+        report->threads = std::move(stats);
+        report->wallSeconds = secondsBetween(wallStart, chrono::steady_clock::now());
+    }
 }
 
 // Optimized With atomic variables and CAS
-void findDivisibleWithAtomic(const vector<int>& data, atomic<int>& count, atomic<int>& minElement) {
+void findDivisibleWithAtomic(const vector<int>& data, atomic<int>& count, atomic<int>& minElement,
+                             ParallelReport* report = nullptr) {
+    DIVSCAN_PROBE(scan__start, "atomic", data.size());
     vector<thread> threads;
+    vector<ThreadStats> stats(NUM_THREADS);
+    auto wallStart = chrono::steady_clock::now();
 
-    auto task = [&](const int start, const int end) {
+    auto task = [&](const int index, const int start, const int end) {
         int localCount = 0;
         int localMin = INT_MAX;
 
+        DIVSCAN_PROBE(chunk__start, index, start, end);
+        TraceSpan chunkSpan("chunk");
+        chunkSpan.setArg("elements", end - start);
+        auto busyStart = chrono::steady_clock::now();
         for (int i = start; i < end; ++i) {
             if (data[i] % DIVISOR == 0) {
                 ++localCount;
                 localMin = min(localMin, data[i]);
             }
         }
+        auto syncStart = chrono::steady_clock::now();
+        chunkSpan.end();
+        DIVSCAN_PROBE(chunk__end, index, localCount, localMin);
         count.fetch_add(localCount);
 
+        TraceSpan casSpan("CAS merge");
+        int retries = 0;
         int currentMin = minElement.load();
         while (localMin < currentMin &&
                !minElement.compare_exchange_weak(currentMin, localMin)) {
-               }
+            ++retries;
+        }
+        casSpan.setArg("retries", retries);
+        DIVSCAN_PROBE(cas__merge, index, localMin, retries);
+        auto syncEnd = chrono::steady_clock::now();
+        stats[index] = {secondsBetween(busyStart, syncStart), secondsBetween(syncStart, syncEnd), end - start};
     };
 
-    int chunkSize = DATA_SIZE / NUM_THREADS;
+    TraceSpan spawnSpan("spawn");
+    int size = static_cast<int>(data.size());
+    int chunkSize = size / NUM_THREADS;
     for (int i = 0; i < NUM_THREADS; ++i) {
         int start = i * chunkSize;
-        int end = (i == NUM_THREADS - 1) ? DATA_SIZE : start + chunkSize;
-        threads.emplace_back(task, start, end);
+        int end = (i == NUM_THREADS - 1) ? size : start + chunkSize;
+        threads.emplace_back(task, i, start, end);
     }
+    spawnSpan.end();
 
+    TraceSpan joinSpan("join");
     for (auto& thread : threads) {
         thread.join();
     }
+    DIVSCAN_PROBE(scan__end, "atomic", count.load(), minElement.load());
+
+    if (report != nullptr) {
+        report->threads = std::move(stats);
+        report->wallSeconds = secondsBetween(wallStart, chrono::steady_clock::now());
+    }
+}
+
+// Shared per-chunk kernel: accumulates into count and minElement
+void accumulateDivisible(const int* values, size_t n, int& count, int& minElement) {
+    for (size_t i = 0; i < n; ++i) {
+        if (values[i] % DIVISOR == 0) {
+            ++count;
+            minElement = min(minElement, values[i]);
+        }
+    }
 }
 
-int main() {
-    vector<int> data = generateData(DATA_SIZE);
+// Snapshot-isolated scans under concurrent writers
+const int BLOCK_SIZE = 1 << 16;
+const int MAX_READERS = 64;
 
-    int count = 0, minElement = 0;
-    atomic atomicCount(0);
-    atomic atomicMinElement(INT_MAX);
+struct Block {
+    vector<int> values;
+};
 
-    // Without parallelization
+struct BlockSnapshot {
+    vector<const Block*> blocks;
+    size_t size = 0;
+};
+
+// Epoch-based reclamation: an object retired at epoch e is freed once every pinned reader is past e
+class EpochManager {
+public:
+    static constexpr uint64_t IDLE = UINT64_MAX;
+
+    EpochManager() {
+        for (auto& slot : slots) {
+            slot.epoch.store(IDLE);
+        }
+    }
+
+    ~EpochManager() {
+        for (auto& entry : retired) {
+            entry.deleter();
+        }
+    }
+
+    void enter(int readerId) {
+        slots[readerId].epoch.store(globalEpoch.load());
+    }
+
+    void exit(int readerId) {
+        slots[readerId].epoch.store(IDLE, memory_order_release);
+    }
+
+    // Called by writers only, under the writer lock
+    void retire(function<void()> deleter) {
+        retired.push_back({globalEpoch.fetch_add(1), std::move(deleter)});
+    }
+
+    void tryReclaim() {
+        uint64_t minPinned = IDLE;
+        for (auto& slot : slots) {
+            minPinned = min(minPinned, slot.epoch.load());
+        }
+        auto it = partition(retired.begin(), retired.end(),
+                            [&](const Retired& entry) { return entry.epoch >= minPinned; });
+        for (auto freeIt = it; freeIt != retired.end(); ++freeIt) {
+            freeIt->deleter();
+        }
+        reclaimed += retired.end() - it;
+        retired.erase(it, retired.end());
+    }
+
+    size_t pending() const { return retired.size(); }
+    size_t reclaimedCount() const { return reclaimed; }
+
+private:
+    struct alignas(64) Slot {
+        atomic<uint64_t> epoch;
+    };
+
+    struct Retired {
+        uint64_t epoch;
+        function<void()> deleter;
+    };
+
+    atomic<uint64_t> globalEpoch{0};
+    Slot slots[MAX_READERS];
+    vector<Retired> retired;
+    size_t reclaimed = 0;
+};
+
+// Copy-on-write block store: writers copy a block and the block table, then publish the new table
+class VersionedBlockStore {
+public:
+    explicit VersionedBlockStore(const vector<int>& data) {
+        auto* snapshot = new BlockSnapshot;
+        snapshot->size = data.size();
+        for (size_t start = 0; start < data.size(); start += BLOCK_SIZE) {
+            size_t end = min(data.size(), start + BLOCK_SIZE);
+            snapshot->blocks.push_back(new Block{vector<int>(data.begin() + start, data.begin() + end)});
+        }
+        root.store(snapshot);
+    }
+
+    ~VersionedBlockStore() {
+        const BlockSnapshot* snapshot = root.load();
+        for (const Block* block : snapshot->blocks) {
+            delete block;
+        }
+        delete snapshot;
+    }
+
+    void write(size_t index, int value) {
+        lock_guard lock(writerMutex);
+        const BlockSnapshot* current = root.load();
+        size_t blockIndex = index / BLOCK_SIZE;
+        const Block* oldBlock = current->blocks[blockIndex];
+
+        auto* newBlock = new Block(*oldBlock);
+        newBlock->values[index % BLOCK_SIZE] = value;
+        auto* next = new BlockSnapshot(*current);
+        next->blocks[blockIndex] = newBlock;
+        root.store(next);
+
+        epochs.retire([current] { delete current; });
+        epochs.retire([oldBlock] { delete oldBlock; });
+        epochs.tryReclaim();
+    }
+
+    void scan(int readerId, int& count, int& minElement) {
+        count = 0;
+        minElement = INT_MAX;
+        epochs.enter(readerId);
+        const BlockSnapshot* snapshot = root.load();
+        for (const Block* block : snapshot->blocks) {
+            accumulateDivisible(block->values.data(), block->values.size(), count, minElement);
+        }
+        epochs.exit(readerId);
+    }
+
+    size_t reclaimedCount() {
+        lock_guard lock(writerMutex);
+        return epochs.reclaimedCount();
+    }
+
+private:
+    atomic<const BlockSnapshot*> root;
+    mutex writerMutex;
+    EpochManager epochs;
+};
+
+// glibc's shared_mutex prefers readers, so back-to-back scans can starve the writer for the whole run.
+// Here a waiting writer holds off new readers, so the lock baseline actually sees the write load.
+class WriterPreferringLock {
+public:
+    void lock_shared() {
+        unique_lock guard(mtx);
+        changed.wait(guard, [&] { return !writing && writersWaiting == 0; });
+        ++readers;
+    }
+
+    void unlock_shared() {
+        lock_guard guard(mtx);
+        if (--readers == 0) {
+            changed.notify_all();
+        }
+    }
+
+    void lock() {
+        unique_lock guard(mtx);
+        ++writersWaiting;
+        changed.wait(guard, [&] { return !writing && readers == 0; });
+        --writersWaiting;
+        writing = true;
+    }
+
+    void unlock() {
+        lock_guard guard(mtx);
+        writing = false;
+        changed.notify_all();
+    }
+
+private:
+    mutex mtx;
+    condition_variable changed;
+    int readers = 0;
+    int writersWaiting = 0;
+    bool writing = false;
+};
+
+// Baseline: readers share the lock, writers take it exclusively
+class RwLockStore {
+public:
+    explicit RwLockStore(const vector<int>& data) : data(data) {}
+
+    void write(size_t index, int value) {
+        unique_lock lock(rwLock);
+        data[index] = value;
+    }
+
+    void scan(int, int& count, int& minElement) {
+        count = 0;
+        minElement = INT_MAX;
+        shared_lock lock(rwLock);
+        accumulateDivisible(data.data(), data.size(), count, minElement);
+    }
+
+private:
+    vector<int> data;
+    WriterPreferringLock rwLock;
+};
+
+// Baseline: optimistic readers retry whenever a writer ran during their scan
+class SeqlockStore {
+public:
+    explicit SeqlockStore(const vector<int>& data) : data(data) {}
+
+    void write(size_t index, int value) {
+        lock_guard lock(writerMutex);
+        uint64_t seq = sequence.load(memory_order_relaxed);
+        sequence.store(seq + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        atomic_ref(data[index]).store(value, memory_order_relaxed);
+        sequence.store(seq + 2, memory_order_release);
+    }
+
+    void scan(int, int& count, int& minElement) {
+        while (true) {
+            uint64_t before = sequence.load(memory_order_acquire);
+            if (before & 1) {
+                retries.fetch_add(1, memory_order_relaxed);
+                continue;
+            }
+            count = 0;
+            minElement = INT_MAX;
+            for (auto& value : data) {
+                int v = atomic_ref(value).load(memory_order_relaxed);
+                if (v % DIVISOR == 0) {
+                    ++count;
+                    minElement = min(minElement, v);
+                }
+            }
+            atomic_thread_fence(memory_order_acquire);
+            if (sequence.load(memory_order_relaxed) == before) {
+                return;
+            }
+            retries.fetch_add(1, memory_order_relaxed);
+        }
+    }
+
+    uint64_t retryCount() const { return retries.load(); }
+
+private:
+    vector<int> data;
+    atomic<uint64_t> sequence{0};
+    atomic<uint64_t> retries{0};
+    mutex writerMutex;
+};
+
+struct ConcurrencyResult {
+    uint64_t scans = 0;
+    uint64_t writes = 0;
+    uint64_t matches = 0;
+    double elapsed = 0;
+};
+
+template <typename Store>
+ConcurrencyResult runReadersUnderWrites(Store& store, size_t size, int readers,
+                                        chrono::milliseconds duration, chrono::microseconds writeInterval) {
+    atomic<bool> stop(false);
+    atomic<uint64_t> scans(0);
+    atomic<uint64_t> matches(0);
+    uint64_t writes = 0;
+    vector<thread> threads;
+
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r] {
+            int count = 0, minElement = 0;
+            while (!stop.load(memory_order_relaxed)) {
+                store.scan(r, count, minElement);
+                scans.fetch_add(1, memory_order_relaxed);
+                matches.fetch_add(count, memory_order_relaxed);
+            }
+        });
+    }
+
+    thread writer([&] {
+        mt19937 gen(42);
+        uniform_int_distribution<size_t> indexDist(0, size - 1);
+        uniform_int_distribution valueDist(0, 99999);
+        while (!stop.load(memory_order_relaxed)) {
+            store.write(indexDist(gen), valueDist(gen));
+            ++writes;
+            this_thread::sleep_for(writeInterval);
+        }
+    });
+
+    auto start = chrono::high_resolution_clock::now();
+    this_thread::sleep_for(duration);
+    stop.store(true);
+    writer.join();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto end = chrono::high_resolution_clock::now();
+
+    return {scans.load(), writes, matches.load(), chrono::duration<double>(end - start).count()};
+}
+
+void printConcurrencyResult(const string& name, const ConcurrencyResult& result, size_t size) {
+    cout << "[*] " << name << "\n";
+    cout << "Scans: " << result.scans << " (" << result.scans / result.elapsed << " scans/s, "
+         << result.scans * size / result.elapsed / 1e9 << " G elements/s), writes: " << result.writes << " ("
+         << result.writes / result.elapsed << " writes/s), matches seen: " << result.matches << endl;
+}
+
+void runSnapshotBenchmark(size_t size, int durationMs, int writeIntervalUs) {
+    vector<int> data = generateData(static_cast<int>(size));
+    int readers = min(max(1, NUM_THREADS), MAX_READERS);
+    auto duration = chrono::milliseconds(durationMs);
+    auto writeInterval = chrono::microseconds(writeIntervalUs);
+
+    {
+        VersionedBlockStore store(data);
+        auto result = runReadersUnderWrites(store, size, readers, duration, writeInterval);
+        printConcurrencyResult("Copy-on-write blocks with epoch reclamation", result, size);
+        cout << "Reclaimed versions: " << store.reclaimedCount() << endl;
+    }
+    {
+        RwLockStore store(data);
+        auto result = runReadersUnderWrites(store, size, readers, duration, writeInterval);
+        printConcurrencyResult("Writer-preferring rwlock", result, size);
+    }
+    {
+        SeqlockStore store(data);
+        auto result = runReadersUnderWrites(store, size, readers, duration, writeInterval);
+        printConcurrencyResult("Seqlock", result, size);
+        cout << "Reader retries: " << store.retryCount() << endl;
+    }
+}
+
+// Sorted-input fast paths
+bool isSortedAscending(const vector<int>& data) {
+    return is_sorted(data.begin(), data.end());
+}
+
+// Smallest multiple of DIVISOR that is >= value
+long long nextMultiple(long long value) {
+    long long remainder = ((value % DIVISOR) + DIVISOR) % DIVISOR;
+    return remainder == 0 ? value : value + (DIVISOR - remainder);
+}
+
+// First position in [first, last) where before() turns false, probing 1, 2, 4, ... elements ahead so
+// the cost is logarithmic in the distance moved rather than in the whole remaining range
+template <typename Before>
+vector<int>::const_iterator gallopSearch(vector<int>::const_iterator first, vector<int>::const_iterator last,
+                                         Before before) {
+    ptrdiff_t step = 1;
+    while (last - first > step && before(first[step])) {
+        first += step;
+        step *= 2;
+    }
+    auto bound = last - first > step ? first + step : last;
+    return partition_point(first, bound, before);
+}
+
+// On ascending data the first divisible value is the minimum, and each multiple of DIVISOR forms one
+// contiguous run; galloping to each run keeps the count linear even when runs are a single element
+void findDivisibleSorted(const vector<int>& data, int& count, int& minElement) {
+    count = 0;
+    minElement = INT_MAX;
+    for (const auto value : data) {
+        if (value % DIVISOR == 0) {
+            minElement = value;
+            break;
+        }
+    }
+
+    // When nearly every multiple is its own short run, the searches cost more than reading each element
+    if (data.size() > 1) {
+        double multiples = (static_cast<double>(data.back()) - data.front()) / DIVISOR;
+        if (multiples >= data.size() / log2(static_cast<double>(data.size()))) {
+            accumulateDivisible(data.data(), data.size(), count, minElement);
+            return;
+        }
+    }
+
+    auto pos = data.cbegin();
+    while (pos != data.cend()) {
+        long long multiple = nextMultiple(*pos);
+        if (multiple > INT_MAX) {
+            break;
+        }
+        auto lower = gallopSearch(pos, data.cend(), [&](int value) { return value < multiple; });
+        if (lower == data.cend()) {
+            break;
+        }
+        if (*lower != multiple) {
+            pos = lower;
+            continue;
+        }
+        auto upper = gallopSearch(lower, data.cend(), [&](int value) { return value <= multiple; });
+        count += static_cast<int>(upper - lower);
+        pos = upper;
+    }
+}
+
+// Divisible values within [low, high]; sorted inputs binary-search the bounds and scan only that slice
+void findDivisibleInRange(const vector<int>& data, int low, int high, bool sorted, int& count, int& minElement) {
+    count = 0;
+    minElement = INT_MAX;
+    if (sorted) {
+        auto begin = lower_bound(data.begin(), data.end(), low);
+        auto end = upper_bound(begin, data.end(), high);
+        accumulateDivisible(data.data() + (begin - data.begin()), end - begin, count, minElement);
+        return;
+    }
+    for (const auto value : data) {
+        if (value >= low && value <= high && value % DIVISOR == 0) {
+            ++count;
+            minElement = min(minElement, value);
+        }
+    }
+}
+
+template <typename F>
+double measureSeconds(F&& f) {
     auto start = chrono::high_resolution_clock::now();
-    findDivisibleWithoutParallel(data, count, minElement);
+    f();
     auto end = chrono::high_resolution_clock::now();
-    double elapsed = chrono::duration<double>(end - start).count();
-    cout << "[*] Without parallelization\n";
+    return chrono::duration<double>(end - start).count();
+}
+
+void runSortedScans(const vector<int>& data, int low, int high) {
+    int count = 0, minElement = 0;
+
+    bool sorted = false;
+    double elapsed = measureSeconds([&] { sorted = isSortedAscending(data); });
+    cout << "[*] Sortedness detection\n";
+    cout << "Sorted: " << (sorted ? "yes" : "no") << ", time: " << elapsed << " s" << endl;
+
+    elapsed = measureSeconds([&] { findDivisibleWithoutParallel(data, count, minElement); });
+    cout << "[*] Generic scan\n";
     cout << "Found: " << count << " elements, minimum: " << minElement
          << ", time: " << elapsed << " s" << endl;
 
-    // With mutex
-    start = chrono::high_resolution_clock::now();
-    findDivisibleWithMutex(data, count, minElement);
-    end = chrono::high_resolution_clock::now();
-    elapsed = chrono::duration<double>(end - start).count();
-    cout << "[*] With mutex\n";
+    elapsed = measureSeconds([&] { findDivisibleSorted(data, count, minElement); });
+    cout << "[*] Sorted fast path\n";
     cout << "Found: " << count << " elements, minimum: " << minElement
          << ", time: " << elapsed << " s" << endl;
 
+    elapsed = measureSeconds([&] { findDivisibleInRange(data, low, high, false, count, minElement); });
+    cout << "[*] Range [" << low << ", " << high << "] generic scan\n";
+    cout << "Found: " << count << " elements, minimum: " << minElement
+         << ", time: " << elapsed << " s" << endl;
 
-    // With atomic variables
-    start = chrono::high_resolution_clock::now();
-    findDivisibleWithAtomic(data, atomicCount, atomicMinElement);
-    end = chrono::high_resolution_clock::now();
-    elapsed = chrono::duration<double>(end - start).count();
-    cout << "[*] With atomic variables\n";
-    cout << "Found: " << atomicCount.load() << " elements, minimum: "
-         << atomicMinElement.load() << ", time: "
-         << elapsed << " s" << endl;
+    elapsed = measureSeconds([&] { findDivisibleInRange(data, low, high, sorted, count, minElement); });
+    cout << "[*] Range [" << low << ", " << high << "] with binary-searched bounds\n";
+    cout << "Found: " << count << " elements, minimum: " << minElement
+         << ", time: " << elapsed << " s" << endl;
+}
+
+// Ascending values with steps of 0-2, so almost every run of one multiple is a single element
+vector<int> generateSortedLowDuplicate(int size) {
+    vector<int> data(size);
+    random_device rd;
+    mt19937 gen(rd());
+    uniform_int_distribution step(0, 2);
+    int value = 0;
+    for (int i = 0; i < size; ++i) {
+        value += step(gen);
+        data[i] = value;
+    }
+    return data;
+}
+
+void runSortedBenchmark(int size, int low, int high) {
+    GeneratorOptions options;
+    options.distribution = Distribution::Sorted;
+    cout << "=== Sorted, values in [0, " << MAX_VALUE << "] (long duplicate runs) ===\n";
+    runSortedScans(generateData(size, options), low, high);
+
+    cout << "=== Sorted, steps of 0-2 (few duplicates) ===\n";
+    runSortedScans(generateSortedLowDuplicate(size), low, high);
+}
+
+// Top-k smallest divisible elements
+// Each worker keeps a max-heap of its k smallest matches; the root is the current cut-off
+vector<int> findSmallestDivisible(const vector<int>& data, int k) {
+    if (k <= 0) {
+        return {};
+    }
+    vector<vector<int>> heaps(NUM_THREADS);
+    vector<thread> threads;
+
+    auto task = [&](const int index, const int start, const int end) {
+        vector<int>& heap = heaps[index];
+        heap.reserve(min<size_t>(k, end - start));
+        for (int i = start; i < end; ++i) {
+            const int value = data[i];
+            if (value % DIVISOR != 0) {
+                continue;
+            }
+            if (static_cast<int>(heap.size()) < k) {
+                heap.push_back(value);
+                push_heap(heap.begin(), heap.end());
+            } else if (value < heap.front()) {
+                pop_heap(heap.begin(), heap.end());
+                heap.back() = value;
+                push_heap(heap.begin(), heap.end());
+            }
+        }
+    };
+
+    int size = static_cast<int>(data.size());
+    int chunkSize = size / NUM_THREADS;
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        int start = i * chunkSize;
+        int end = (i == NUM_THREADS - 1) ? size : start + chunkSize;
+        threads.emplace_back(task, i, start, end);
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    vector<int> merged;
+    for (const auto& heap : heaps) {
+        merged.insert(merged.end(), heap.begin(), heap.end());
+    }
+    int resultSize = min<int>(k, merged.size());
+    partial_sort(merged.begin(), merged.begin() + resultSize, merged.end());
+    merged.resize(resultSize);
+    return merged;
+}
+
+// Baseline: collect every match, then partially sort
+vector<int> findSmallestDivisibleBySorting(const vector<int>& data, int k) {
+    vector<int> matches;
+    for (const auto value : data) {
+        if (value % DIVISOR == 0) {
+            matches.push_back(value);
+        }
+    }
+    int resultSize = min<int>(max(k, 0), matches.size());
+    partial_sort(matches.begin(), matches.begin() + resultSize, matches.end());
+    matches.resize(resultSize);
+    return matches;
+}
+
+void runTopKBenchmark(int size) {
+    vector<int> data = generateData(size);
+    for (int k : {1, 10, 100, 1000, 10000}) {
+        vector<int> heapResult, sortResult;
+        double heapElapsed = measureSeconds([&] { heapResult = findSmallestDivisible(data, k); });
+        double sortElapsed = measureSeconds([&] { sortResult = findSmallestDivisibleBySorting(data, k); });
+        cout << "[*] Top-" << k << " smallest divisible\n";
+        cout << "Largest kept: " << (heapResult.empty() ? INT_MAX : heapResult.back())
+             << ", matches baseline: " << (heapResult == sortResult ? "yes" : "no")
+             << ", bounded heaps: " << heapElapsed << " s, collect and sort: " << sortElapsed << " s" << endl;
+    }
+}
+
+// Parallel selection vector: indices and values of every divisible element
+struct Selection {
+    vector<int> indices;
+    vector<int> values;
+};
+
+// x is divisible by an odd d iff x * d^-1 (mod 2^32) + bias <= 2 * bias, bias = INT_MAX / d
+constexpr uint32_t modularInverse(uint32_t d) {
+    uint32_t inverse = d;
+    for (int i = 0; i < 5; ++i) {
+        inverse *= 2 - d * inverse;
+    }
+    return inverse;
+}
+
+constexpr bool DIVISOR_IS_ODD = DIVISOR % 2 != 0;
+constexpr uint32_t DIVISOR_INVERSE = modularInverse(DIVISOR);
+constexpr uint32_t DIVISOR_BIAS = INT_MAX / DIVISOR;
+
+// Scalar tail shared by every selectRange variant
+int selectRangeScalar(const vector<int>& data, int i, int end, int* indices, int* values, int written) {
+    for (; i < end; ++i) {
+        if (data[i] % DIVISOR == 0) {
+            indices[written] = i;
+            values[written] = data[i];
+            ++written;
+        }
+    }
+    return written;
+}
+
+#if defined(__x86_64__)
+// Lane permutation that moves the set lanes of an 8-bit mask to the front
+struct LeftPackTable {
+    alignas(32) int lanes[256][8];
+
+    LeftPackTable() {
+        for (int mask = 0; mask < 256; ++mask) {
+            int packed = 0;
+            for (int lane = 0; lane < 8; ++lane) {
+                if (mask & (1 << lane)) {
+                    lanes[mask][packed++] = lane;
+                }
+            }
+            while (packed < 8) {
+                lanes[mask][packed++] = 0;
+            }
+        }
+    }
+};
+
+const LeftPackTable LEFT_PACK;
+
+// The SIMD variants are compiled for their own ISA only, so the rest of the binary keeps the baseline target
+__attribute__((target("avx512f")))
+int selectRangeAvx512(const vector<int>& data, int start, int end, int* indices, int* values, int) {
+    int written = 0;
+    int i = start;
+    if constexpr (DIVISOR_IS_ODD) {
+        const __m512i inverse = _mm512_set1_epi32(static_cast<int>(DIVISOR_INVERSE));
+        const __m512i bias = _mm512_set1_epi32(static_cast<int>(DIVISOR_BIAS));
+        const __m512i limit = _mm512_set1_epi32(static_cast<int>(2 * DIVISOR_BIAS));
+        const __m512i step = _mm512_set1_epi32(16);
+        __m512i index = _mm512_add_epi32(_mm512_set1_epi32(i),
+                                         _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+        for (; i + 16 <= end; i += 16) {
+            __m512i value = _mm512_loadu_si512(data.data() + i);
+            __m512i scaled = _mm512_add_epi32(_mm512_mullo_epi32(value, inverse), bias);
+            __mmask16 mask = _mm512_cmple_epu32_mask(scaled, limit);
+            _mm512_mask_compressstoreu_epi32(indices + written, mask, index);
+            _mm512_mask_compressstoreu_epi32(values + written, mask, value);
+            written += __builtin_popcount(mask);
+            index = _mm512_add_epi32(index, step);
+        }
+    }
+    return selectRangeScalar(data, i, end, indices, values, written);
+}
+
+__attribute__((target("avx2")))
+int selectRangeAvx2(const vector<int>& data, int start, int end, int* indices, int* values, int capacity) {
+    int written = 0;
+    int i = start;
+    if constexpr (DIVISOR_IS_ODD) {
+        const __m256i inverse = _mm256_set1_epi32(static_cast<int>(DIVISOR_INVERSE));
+        const __m256i bias = _mm256_set1_epi32(static_cast<int>(DIVISOR_BIAS));
+        const __m256i limit = _mm256_set1_epi32(static_cast<int>(2 * DIVISOR_BIAS));
+        const __m256i step = _mm256_set1_epi32(8);
+        __m256i index = _mm256_add_epi32(_mm256_set1_epi32(i), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        // Full 8-lane stores may spill garbage past the last match, so stop while there is room
+        for (; i + 8 <= end && written + 8 <= capacity; i += 8) {
+            __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data.data() + i));
+            __m256i scaled = _mm256_add_epi32(_mm256_mullo_epi32(value, inverse), bias);
+            __m256i passed = _mm256_cmpeq_epi32(_mm256_min_epu32(scaled, limit), scaled);
+            int mask = _mm256_movemask_ps(_mm256_castsi256_ps(passed));
+            __m256i permutation = _mm256_load_si256(reinterpret_cast<const __m256i*>(LEFT_PACK.lanes[mask]));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(indices + written),
+                                _mm256_permutevar8x32_epi32(index, permutation));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(values + written),
+                                _mm256_permutevar8x32_epi32(value, permutation));
+            written += __builtin_popcount(mask);
+            index = _mm256_add_epi32(index, step);
+        }
+    }
+    return selectRangeScalar(data, i, end, indices, values, written);
+}
+#endif
+
+int selectRangeGeneric(const vector<int>& data, int start, int end, int* indices, int* values, int) {
+    return selectRangeScalar(data, start, end, indices, values, 0);
+}
+
+using SelectRangeFn = int (*)(const vector<int>&, int, int, int*, int*, int);
+
+// Picks the widest variant the running CPU supports
+SelectRangeFn resolveSelectRange() {
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return selectRangeAvx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return selectRangeAvx2;
+    }
+#endif
+    return selectRangeGeneric;
+}
+
+const SelectRangeFn SELECT_RANGE = resolveSelectRange();
+
+// Writes matches from [start, end) and returns how many were written; never writes past capacity
+int selectRange(const vector<int>& data, int start, int end, int* indices, int* values, int capacity) {
+    return SELECT_RANGE(data, start, end, indices, values, capacity);
+}
+
+// Count pass, exclusive prefix sum over per-thread counts, then lock-free writes into disjoint slices
+Selection selectDivisible(const vector<int>& data) {
+    vector<int> counts(NUM_THREADS, 0);
+    vector<int> offsets(NUM_THREADS + 1, 0);
+    vector<thread> threads;
+    Selection selection;
+
+    int size = static_cast<int>(data.size());
+    int chunkSize = size / NUM_THREADS;
+    auto chunkStart = [&](int i) { return i * chunkSize; };
+    auto chunkEnd = [&](int i) { return (i == NUM_THREADS - 1) ? size : chunkStart(i) + chunkSize; };
+
+    auto countTask = [&](const int index) {
+        int localCount = 0;
+        for (int i = chunkStart(index); i < chunkEnd(index); ++i) {
+            localCount += data[i] % DIVISOR == 0;
+        }
+        counts[index] = localCount;
+    };
+
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        threads.emplace_back(countTask, i);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    threads.clear();
+
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        offsets[i + 1] = offsets[i] + counts[i];
+    }
+    selection.indices.resize(offsets[NUM_THREADS]);
+    selection.values.resize(offsets[NUM_THREADS]);
+
+    auto writeTask = [&](const int index) {
+        int offset = offsets[index];
+        int capacity = counts[index];
+        selectRange(data, chunkStart(index), chunkEnd(index),
+                    selection.indices.data() + offset, selection.values.data() + offset, capacity);
+    };
+
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        threads.emplace_back(writeTask, i);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    return selection;
+}
+
+void runSelectionBenchmark(int size) {
+    vector<int> data = generateData(size);
+    Selection parallel, sequential;
+
+    double elapsed = measureSeconds([&] { parallel = selectDivisible(data); });
+    cout << "[*] Parallel selection vector\n";
+    cout << "Selected: " << parallel.values.size() << " elements, time: " << elapsed << " s" << endl;
+
+    elapsed = measureSeconds([&] {
+        for (int i = 0; i < size; ++i) {
+            if (data[i] % DIVISOR == 0) {
+                sequential.indices.push_back(i);
+                sequential.values.push_back(data[i]);
+            }
+        }
+    });
+    cout << "[*] Sequential push_back\n";
+    cout << "Selected: " << sequential.values.size() << " elements, time: " << elapsed << " s" << endl;
+    cout << "Outputs match: "
+         << (parallel.indices == sequential.indices && parallel.values == sequential.values ? "yes" : "no") << endl;
+}
+
+// Residue-class histogram: count and minimum for every value % d in one pass
+struct ResidueStats {
+    int count = 0;
+    int minElement = INT_MAX;
+};
+
+const int RESIDUE_BLOCK = 1024;
+const int MAX_FIXED_RESIDUE_DIVISOR = 16;
+
+void accumulateResidues(const int* values, size_t n, int d, ResidueStats* stats) {
+    for (size_t i = 0; i < n; ++i) {
+        int residue = ((values[i] % d) + d) % d;
+        ++stats[residue].count;
+        stats[residue].minElement = min(stats[residue].minElement, values[i]);
+    }
+}
+
+// Compile-time divisor: the residue pass becomes a multiply-shift that the compiler vectorises,
+// and four interleaved sub-histograms keep consecutive updates off the same counter
+template <int D>
+void accumulateResiduesFixed(const int* values, size_t n, ResidueStats* stats) {
+    const int LANES = 4;
+    int residues[RESIDUE_BLOCK];
+    int counts[LANES][D] = {};
+    int mins[LANES][D];
+    for (auto& lane : mins) {
+        fill(begin(lane), end(lane), INT_MAX);
+    }
+
+    for (size_t blockStart = 0; blockStart < n; blockStart += RESIDUE_BLOCK) {
+        const int blockSize = static_cast<int>(min<size_t>(RESIDUE_BLOCK, n - blockStart));
+        const int* block = values + blockStart;
+        for (int i = 0; i < blockSize; ++i) {
+            residues[i] = ((block[i] % D) + D) % D;
+        }
+        for (int i = 0; i < blockSize; ++i) {
+            const int lane = i & (LANES - 1);
+            ++counts[lane][residues[i]];
+            mins[lane][residues[i]] = min(mins[lane][residues[i]], block[i]);
+        }
+    }
+
+    for (int lane = 0; lane < LANES; ++lane) {
+        for (int r = 0; r < D; ++r) {
+            stats[r].count += counts[lane][r];
+            stats[r].minElement = min(stats[r].minElement, mins[lane][r]);
+        }
+    }
+}
+
+using ResidueKernel = void (*)(const int*, size_t, ResidueStats*);
+
+template <size_t... D>
+constexpr array<ResidueKernel, sizeof...(D)> makeResidueKernels(index_sequence<D...>) {
+    return {accumulateResiduesFixed<static_cast<int>(D) + 1>...};
+}
+
+const auto FIXED_RESIDUE_KERNELS = makeResidueKernels(make_index_sequence<MAX_FIXED_RESIDUE_DIVISOR>());
+
+vector<ResidueStats> residueHistogram(const vector<int>& data, int d, bool allowFixed = true) {
+    vector<vector<ResidueStats>> localStats(NUM_THREADS, vector<ResidueStats>(d));
+    vector<thread> threads;
+    bool fixed = allowFixed && d <= MAX_FIXED_RESIDUE_DIVISOR;
+
+    auto task = [&](const int index, const int start, const int end) {
+        if (fixed) {
+            FIXED_RESIDUE_KERNELS[d - 1](data.data() + start, end - start, localStats[index].data());
+        } else {
+            accumulateResidues(data.data() + start, end - start, d, localStats[index].data());
+        }
+    };
+
+    int size = static_cast<int>(data.size());
+    int chunkSize = size / NUM_THREADS;
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        int start = i * chunkSize;
+        int end = (i == NUM_THREADS - 1) ? size : start + chunkSize;
+        threads.emplace_back(task, i, start, end);
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    vector<ResidueStats> merged(d);
+    for (const auto& stats : localStats) {
+        for (int r = 0; r < d; ++r) {
+            merged[r].count += stats[r].count;
+            merged[r].minElement = min(merged[r].minElement, stats[r].minElement);
+        }
+    }
+    return merged;
+}
+
+void runResidueBenchmark(int d, int size) {
+    vector<int> data = generateData(size);
+    vector<ResidueStats> generic, fixed;
+
+    double genericElapsed = measureSeconds([&] { generic = residueHistogram(data, d, false); });
+    double fixedElapsed = measureSeconds([&] { fixed = residueHistogram(data, d); });
+
+    cout << "[*] Residue histogram for d = " << d << "\n";
+    for (int r = 0; r < d && r < 32; ++r) {
+        cout << "value % " << d << " == " << r << ": " << fixed[r].count
+             << " elements, minimum: " << fixed[r].minElement << "\n";
+    }
+    bool same = true;
+    for (int r = 0; r < d; ++r) {
+        same = same && generic[r].count == fixed[r].count && generic[r].minElement == fixed[r].minElement;
+    }
+    cout << "Generic: " << genericElapsed << " s, "
+         << (d <= MAX_FIXED_RESIDUE_DIVISOR ? "fixed-divisor kernel: " : "fixed-divisor kernel unavailable: ")
+         << fixedElapsed << " s, results match: " << (same ? "yes" : "no") << endl;
+}
+
+// Sliding-window continuous query over the last W arrivals
+class SlidingWindowScanner {
+public:
+    explicit SlidingWindowScanner(size_t window) : window(window), divisibleFlags(window, 0) {}
+
+    // Amortised O(1): the ring of flags keeps the running count, the monotonic deque keeps the min
+    void push(int value) {
+        size_t slot = arrivals % window;
+        if (arrivals >= window) {
+            currentCount -= divisibleFlags[slot];
+            while (!candidates.empty() && candidates.front().first + window <= arrivals) {
+                candidates.pop_front();
+            }
+        }
+
+        bool divisible = value % DIVISOR == 0;
+        divisibleFlags[slot] = divisible;
+        currentCount += divisible;
+        if (divisible) {
+            while (!candidates.empty() && candidates.back().second >= value) {
+                candidates.pop_back();
+            }
+            candidates.emplace_back(arrivals, value);
+        }
+        ++arrivals;
+    }
+
+    // A batch at least as long as the window replaces it entirely, so only its tail is ingested
+    void pushBatch(const int* values, size_t n) {
+        if (n >= window) {
+            fill(divisibleFlags.begin(), divisibleFlags.end(), 0);
+            candidates.clear();
+            currentCount = 0;
+            arrivals += n - window;
+            values += n - window;
+            n = window;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            push(values[i]);
+        }
+    }
+
+    int count() const { return currentCount; }
+    int minElement() const { return candidates.empty() ? INT_MAX : candidates.front().second; }
+
+private:
+    size_t window;
+    size_t arrivals = 0;
+    int currentCount = 0;
+    vector<uint8_t> divisibleFlags;
+    // (arrival index, value) of divisible elements with strictly increasing values
+    deque<pair<size_t, int>> candidates;
+};
+
+void runWindowBenchmark(int window, int arrivals, int batchSize) {
+    vector<int> stream = generateData(arrivals);
+    SlidingWindowScanner scanner(window);
+    long long checksum = 0;
+
+    double elapsed = measureSeconds([&] {
+        for (int i = 0; i < arrivals; ++i) {
+            scanner.push(stream[i]);
+            checksum += scanner.count() + scanner.minElement();
+        }
+    });
+    cout << "[*] Sliding window, per-arrival updates\n";
+    cout << "Window: " << window << ", count: " << scanner.count() << ", minimum: " << scanner.minElement()
+         << ", time: " << elapsed * 1e9 / arrivals << " ns/arrival" << endl;
+
+    SlidingWindowScanner batched(window);
+    elapsed = measureSeconds([&] {
+        for (int start = 0; start < arrivals; start += batchSize) {
+            batched.pushBatch(stream.data() + start, min(batchSize, arrivals - start));
+            checksum += batched.count() + batched.minElement();
+        }
+    });
+    cout << "[*] Sliding window, batches of " << batchSize << "\n";
+    cout << "Count: " << batched.count() << ", minimum: " << batched.minElement()
+         << ", time: " << elapsed * 1e9 / arrivals << " ns/arrival" << endl;
+
+    // Batch boundaries must agree with per-arrival updates, including once eviction has started
+    SlidingWindowScanner perArrival(window);
+    SlidingWindowScanner perBatch(window);
+    bool batchesMatch = true;
+    for (int start = 0; start < arrivals; start += batchSize) {
+        int end = min(arrivals, start + batchSize);
+        for (int i = start; i < end; ++i) {
+            perArrival.push(stream[i]);
+        }
+        perBatch.pushBatch(stream.data() + start, end - start);
+        batchesMatch = batchesMatch && perBatch.count() == perArrival.count()
+                       && perBatch.minElement() == perArrival.minElement();
+    }
+    cout << "Batches match per-arrival updates: " << (batchesMatch ? "yes" : "no") << endl;
+
+    // Baseline: re-scan the whole window on a sample of arrivals taken once the window is full
+    const int rescans = min(arrivals, 2000);
+    const int firstRescan = min(window, arrivals - rescans);
+    SlidingWindowScanner reference(window);
+    for (int i = 0; i < firstRescan; ++i) {
+        reference.push(stream[i]);
+    }
+    bool same = true;
+    elapsed = 0;
+    for (int i = firstRescan; i < firstRescan + rescans; ++i) {
+        reference.push(stream[i]);
+        int count = 0, minElement = 0;
+        vector<int> contents(stream.begin() + max(0, i + 1 - window), stream.begin() + i + 1);
+        elapsed += measureSeconds([&] { findDivisibleWithoutParallel(contents, count, minElement); });
+        same = same && count == reference.count() && minElement == reference.minElement();
+    }
+    cout << "[*] Re-running findDivisibleWithoutParallel over the window\n";
+    cout << "Time: " << elapsed * 1e9 / rescans << " ns/arrival, matches streaming operator: "
+         << (same ? "yes" : "no") << " (checksum " << checksum << ")" << endl;
+}
+
+// Segmented reduction: count and min per segment of a flat buffer, segment i is [offsets[i], offsets[i + 1])
+struct SegmentStats {
+    int count = 0;
+    int minElement = INT_MAX;
+};
+
+void findDivisibleSegmentedSequential(const vector<int>& values, const vector<int>& offsets,
+                                      vector<SegmentStats>& results) {
+    int segments = static_cast<int>(offsets.size()) - 1;
+    results.assign(segments, {});
+    for (int seg = 0; seg < segments; ++seg) {
+        accumulateDivisible(values.data() + offsets[seg], offsets[seg + 1] - offsets[seg],
+                            results[seg].count, results[seg].minElement);
+    }
+}
+
+// Baseline: every worker gets the same number of segments regardless of their length
+void findDivisibleSegmentedBySegmentCount(const vector<int>& values, const vector<int>& offsets,
+                                          vector<SegmentStats>& results) {
+    int segments = static_cast<int>(offsets.size()) - 1;
+    results.assign(segments, {});
+    vector<thread> threads;
+
+    auto task = [&](const int start, const int end) {
+        for (int seg = start; seg < end; ++seg) {
+            accumulateDivisible(values.data() + offsets[seg], offsets[seg + 1] - offsets[seg],
+                                results[seg].count, results[seg].minElement);
+        }
+    };
+
+    int chunkSize = segments / NUM_THREADS;
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        int start = i * chunkSize;
+        int end = (i == NUM_THREADS - 1) ? segments : start + chunkSize;
+        threads.emplace_back(task, start, end);
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+// Every worker gets the same number of elements; a segment cut by a worker boundary is
+// reduced in pieces and merged after join, so long segments cannot pile up on one thread
+void findDivisibleSegmented(const vector<int>& values, const vector<int>& offsets, vector<SegmentStats>& results) {
+    int segments = static_cast<int>(offsets.size()) - 1;
+    results.assign(segments, {});
+    vector<vector<pair<int, SegmentStats>>> partials(NUM_THREADS);
+    vector<thread> threads;
+
+    auto task = [&](const int index, const int start, const int end) {
+        int seg = static_cast<int>(upper_bound(offsets.begin(), offsets.end(), start) - offsets.begin()) - 1;
+        for (; seg < segments && offsets[seg] < end; ++seg) {
+            int segStart = max(start, offsets[seg]);
+            int segEnd = min(end, offsets[seg + 1]);
+            SegmentStats stats;
+            accumulateDivisible(values.data() + segStart, segEnd - segStart, stats.count, stats.minElement);
+            if (offsets[seg] >= start && offsets[seg + 1] <= end) {
+                results[seg] = stats;
+            } else {
+                partials[index].emplace_back(seg, stats);
+            }
+        }
+    };
+
+    int size = segments > 0 ? offsets[segments] : 0;
+    int chunkSize = size / NUM_THREADS;
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        int start = i * chunkSize;
+        int end = (i == NUM_THREADS - 1) ? size : start + chunkSize;
+        threads.emplace_back(task, i, start, end);
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (const auto& workerPartials : partials) {
+        for (const auto& [seg, stats] : workerPartials) {
+            results[seg].count += stats.count;
+            results[seg].minElement = min(results[seg].minElement, stats.minElement);
+        }
+    }
+}
+
+void runSegmentedBenchmark(int segments, int averageLength) {
+    // Mostly short segments with an occasional long one, as in the production traffic
+    mt19937 gen(42);
+    uniform_int_distribution shortLength(0, 2 * averageLength);
+    bernoulli_distribution isLong(0.001);
+    vector<int> offsets(segments + 1, 0);
+    for (int i = 0; i < segments; ++i) {
+        int length = isLong(gen) ? 100 * averageLength : shortLength(gen);
+        offsets[i + 1] = offsets[i] + length;
+    }
+    vector<int> values = generateData(offsets[segments]);
+    vector<SegmentStats> sequential, bySegments, byElements;
+
+    double elapsed = measureSeconds([&] { findDivisibleSegmentedSequential(values, offsets, sequential); });
+    cout << "[*] Segments: " << segments << ", elements: " << offsets[segments] << "\n";
+    cout << "Sequential: " << elapsed << " s" << endl;
+
+    elapsed = measureSeconds([&] { findDivisibleSegmentedBySegmentCount(values, offsets, bySegments); });
+    cout << "Balanced by segment count: " << elapsed << " s" << endl;
+
+    elapsed = measureSeconds([&] { findDivisibleSegmented(values, offsets, byElements); });
+    cout << "Balanced by element count: " << elapsed << " s" << endl;
+
+    bool same = true;
+    for (int i = 0; i < segments; ++i) {
+        same = same && sequential[i].count == byElements[i].count && sequential[i].minElement == byElements[i].minElement
+               && sequential[i].count == bySegments[i].count && sequential[i].minElement == bySegments[i].minElement;
+    }
+    cout << "Results match: " << (same ? "yes" : "no") << endl;
+}
+
+// Persistent worker pool with configurable waiting
+enum class WaitPolicy {
+    Spin,
+    SpinThenPark,
+    Park
+};
+
+const vector<pair<string, WaitPolicy>> WAIT_POLICIES = {
+    {"spin", WaitPolicy::Spin},
+    {"spin-then-park", WaitPolicy::SpinThenPark},
+    {"park", WaitPolicy::Park},
+};
+
+void futexWait(atomic<uint32_t>& word, uint32_t expected) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+}
+
+void futexWakeAll(atomic<uint32_t>& word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+class WorkerPool {
+public:
+    WorkerPool(int workers, WaitPolicy policy, int spinLimit = 2000) : policy(policy), spinLimit(spinLimit) {
+        for (int i = 0; i < workers; ++i) {
+            threads.emplace_back(&WorkerPool::workerLoop, this, i);
+        }
+    }
+
+    ~WorkerPool() {
+        stopping.store(true);
+        publish(generation, generation.load() + 1, parkedWorkers);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    int size() const { return static_cast<int>(threads.size()); }
+
+    // Runs task(workerIndex) on every worker and returns once all of them finished
+    void run(function<void(int)> job) {
+        task = std::move(job);
+        pending.store(size());
+        uint32_t round = generation.load() + 1;
+        publish(generation, round, parkedWorkers);
+        waitWhileEqual(completed, round - 1, parkedDispatchers);
+    }
+
+private:
+    // The waiter count makes the wake syscall free when nobody is parked
+    void publish(atomic<uint32_t>& word, uint32_t value, atomic<uint32_t>& waiters) {
+        word.store(value);
+        if (waiters.load() > 0) {
+            futexWakeAll(word);
+        }
+    }
+
+    void waitWhileEqual(atomic<uint32_t>& word, uint32_t value, atomic<uint32_t>& waiters) {
+        if (policy != WaitPolicy::Park) {
+            for (int spins = 0; policy == WaitPolicy::Spin || spins < spinLimit; ++spins) {
+                if (word.load(memory_order_acquire) != value) {
+                    return;
+                }
+                cpuRelax();
+            }
+        }
+        waiters.fetch_add(1);
+        while (word.load() == value) {
+            futexWait(word, value);
+        }
+        waiters.fetch_sub(1);
+    }
+
+    void workerLoop(int index) {
+        uint32_t seen = 0;
+        while (true) {
+            waitWhileEqual(generation, seen, parkedWorkers);
+            seen = generation.load();
+            if (stopping.load()) {
+                return;
+            }
+            task(index);
+            if (pending.fetch_sub(1) == 1) {
+                publish(completed, seen, parkedDispatchers);
+            }
+        }
+    }
+
+    WaitPolicy policy;
+    int spinLimit;
+    vector<thread> threads;
+    function<void(int)> task;
+    atomic<bool> stopping{false};
+    alignas(64) atomic<uint32_t> generation{0};
+    alignas(64) atomic<uint32_t> completed{0};
+    alignas(64) atomic<uint32_t> pending{0};
+    atomic<uint32_t> parkedWorkers{0};
+    atomic<uint32_t> parkedDispatchers{0};
+};
+
+// One worker's running count/min on its own cache line, so workers can accumulate in place without false sharing
+struct alignas(64) WorkerResult : SegmentStats {};
+
+// Same split as findDivisibleWithMutex, but on pooled workers with per-worker results merged after the run
+void findDivisibleWithPool(WorkerPool& pool, const vector<int>& data, int& count, int& minElement) {
+    const int workers = pool.size();
+    vector<WorkerResult> local(workers);
+    const int size = static_cast<int>(data.size());
+    const int chunkSize = size / workers;
+
+    pool.run([&](const int index) {
+        int start = index * chunkSize;
+        int end = (index == workers - 1) ? size : start + chunkSize;
+        accumulateDivisible(data.data() + start, end - start, local[index].count, local[index].minElement);
+    });
+
+    count = 0;
+    minElement = INT_MAX;
+    for (const auto& stats : local) {
+        count += stats.count;
+        minElement = min(minElement, stats.minElement);
+    }
+}
+
+void printLatencies(const string& name, vector<double>& latencies) {
+    sort(latencies.begin(), latencies.end());
+    double total = 0;
+    for (double latency : latencies) {
+        total += latency;
+    }
+    cout << "[*] " << name << "\n";
+    cout << "Mean: " << total / latencies.size() * 1e6 << " us, median: "
+         << latencies[latencies.size() / 2] * 1e6 << " us, max: " << latencies.back() * 1e6 << " us" << endl;
+}
+
+void runWakeupBenchmark(int size, int iterations) {
+    vector<int> data = generateData(size);
+    int count = 0, minElement = 0;
+    vector<double> latencies(iterations);
+
+    for (int i = 0; i < iterations; ++i) {
+        latencies[i] = measureSeconds([&] { findDivisibleWithMutex(data, count, minElement); });
+    }
+    printLatencies("Spawning threads per call (findDivisibleWithMutex)", latencies);
+
+    for (const auto& [name, policy] : WAIT_POLICIES) {
+        WorkerPool pool(NUM_THREADS, policy);
+        findDivisibleWithPool(pool, data, count, minElement);
+        for (int i = 0; i < iterations; ++i) {
+            latencies[i] = measureSeconds([&] { findDivisibleWithPool(pool, data, count, minElement); });
+        }
+        printLatencies("Worker pool, " + name, latencies);
+    }
+    cout << "Found: " << count << " elements, minimum: " << minElement << endl;
+}
+
+// Adaptive concurrency: ramp active workers up while throughput still improves, hold at the knee and
+// keep probing its neighbours
+const int ADAPTIVE_CHUNK = 1 << 20;
+
+struct AdaptiveReport {
+    int chosenWorkers = 1;
+    // (active workers, elements per second) for every measurement interval
+    vector<pair<int, double>> samples;
+};
+
+void findDivisibleAdaptive(const vector<int>& data, int maxWorkers, int& count, int& minElement,
+                           AdaptiveReport& report, chrono::milliseconds interval = chrono::milliseconds(20),
+                           double minGain = 0.10, int reprobeIntervals = 10) {
+    const long long size = static_cast<long long>(data.size());
+    atomic<long long> nextChunk(0);
+    atomic<long long> processed(0);
+    atomic<uint32_t> activeWorkers(1);
+    atomic<bool> finished(false);
+    vector<WorkerResult> local(maxWorkers);
+    vector<thread> threads;
+
+    auto task = [&](const int index) {
+        SegmentStats& result = local[index];
+        while (!finished.load()) {
+            uint32_t active = activeWorkers.load();
+            if (static_cast<uint32_t>(index) >= active) {
+                futexWait(activeWorkers, active);
+                continue;
+            }
+            long long start = nextChunk.fetch_add(ADAPTIVE_CHUNK);
+            if (start >= size) {
+                break;
+            }
+            long long end = min(size, start + ADAPTIVE_CHUNK);
+            accumulateDivisible(data.data() + start, end - start, result.count, result.minElement);
+            processed.fetch_add(end - start, memory_order_relaxed);
+        }
+    };
+
+    for (int i = 0; i < maxWorkers; ++i) {
+        threads.emplace_back(task, i);
+    }
+
+    // Hill climbing on measured throughput: keep a worker only if it bought at least minGain.
+    // Once settled, a neighbouring level is probed every reprobeIntervals intervals, alternating up and
+    // down, so the choice follows co-tenants that start or stop competing for cores during the scan
+    int level = 1;
+    int bestLevel = 1;
+    double bestRate = 0;
+    bool settled = false;
+    int steadyIntervals = 0;
+    double steadyRate = 0;
+    int probeFrom = 0;
+    double probeBaseline = 0;
+    bool probeUp = true;
+    long long lastProcessed = 0;
+    auto lastTime = chrono::high_resolution_clock::now();
+    while (processed.load() < size) {
+        this_thread::sleep_for(interval);
+        auto now = chrono::high_resolution_clock::now();
+        long long done = processed.load();
+        double rate = (done - lastProcessed) / chrono::duration<double>(now - lastTime).count();
+        lastProcessed = done;
+        lastTime = now;
+        // The last interval ends when the data runs out, not when the timer does, so its rate is not a sample
+        if (done >= size) {
+            break;
+        }
+        report.samples.emplace_back(level, rate);
+
+        if (!settled) {
+            if (rate > bestRate * (1 + minGain)) {
+                bestRate = rate;
+                bestLevel = level;
+                if (level < maxWorkers) {
+                    ++level;
+                } else {
+                    settled = true;
+                }
+            } else {
+                level = bestLevel;
+                settled = true;
+            }
+        } else if (probeFrom != 0) {
+            // Same rule as the ramp: an extra worker must buy minGain, dropping one may cost less than that
+            bool keep = level > probeFrom ? rate > probeBaseline * (1 + minGain)
+                                          : rate >= probeBaseline * (1 - minGain);
+            if (!keep) {
+                level = probeFrom;
+            }
+            probeFrom = 0;
+        } else {
+            steadyRate += rate;
+            if (++steadyIntervals >= reprobeIntervals) {
+                int candidate = level + (probeUp ? 1 : -1);
+                if (candidate < 1 || candidate > maxWorkers) {
+                    candidate = level + (probeUp ? -1 : 1);
+                }
+                probeUp = !probeUp;
+                if (candidate >= 1 && candidate <= maxWorkers) {
+                    probeFrom = level;
+                    probeBaseline = steadyRate / steadyIntervals;
+                    level = candidate;
+                }
+                steadyIntervals = 0;
+                steadyRate = 0;
+            }
+        }
+        activeWorkers.store(level);
+        futexWakeAll(activeWorkers);
+    }
+
+    finished.store(true);
+    activeWorkers.store(maxWorkers);
+    futexWakeAll(activeWorkers);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // A scan that ends mid-ramp has only validated bestLevel; the next candidate never got a full interval
+    report.chosenWorkers = !settled ? bestLevel : probeFrom != 0 ? probeFrom : level;
+    count = 0;
+    minElement = INT_MAX;
+    for (const auto& stats : local) {
+        count += stats.count;
+        minElement = min(minElement, stats.minElement);
+    }
+}
+
+void runAdaptiveBenchmark(int size, int maxWorkers) {
+    vector<int> data = generateData(size);
+    int count = 0, minElement = 0;
+    AdaptiveReport report;
+
+    double elapsed = measureSeconds([&] { findDivisibleAdaptive(data, maxWorkers, count, minElement, report); });
+    vector<double> totalRate(maxWorkers + 1, 0);
+    vector<int> intervals(maxWorkers + 1, 0);
+    for (const auto& [workers, rate] : report.samples) {
+        totalRate[workers] += rate;
+        ++intervals[workers];
+    }
+    cout << "[*] Adaptive concurrency (up to " << maxWorkers << " workers)\n";
+    for (int workers = 1; workers <= maxWorkers; ++workers) {
+        if (intervals[workers] > 0) {
+            cout << "Active workers: " << workers << ", intervals: " << intervals[workers] << ", mean throughput: "
+                 << totalRate[workers] / intervals[workers] / 1e9 << " G elements/s\n";
+        }
+    }
+    cout << "Chosen concurrency: " << report.chosenWorkers << "\n";
+    cout << "Found: " << count << " elements, minimum: " << minElement
+         << ", time: " << elapsed << " s" << endl;
+}
+
+// Working-set sweep from L1 to DRAM sizes
+long cacheSizeBytes(int name, long fallback) {
+    long size = sysconf(name);
+    return size > 0 ? size : fallback;
+}
+
+struct SweepPoint {
+    string level;
+    size_t bytes;
+};
+
+vector<SweepPoint> sweepPoints(size_t maxBytes) {
+    long l1 = cacheSizeBytes(_SC_LEVEL1_DCACHE_SIZE, 32 << 10);
+    long l2 = cacheSizeBytes(_SC_LEVEL2_CACHE_SIZE, 1 << 20);
+    long l3 = cacheSizeBytes(_SC_LEVEL3_CACHE_SIZE, 32 << 20);
+    vector<SweepPoint> points = {{"L1", l1 / 2ul}, {"L2", l2 / 2ul}, {"L3", l3 / 2ul}};
+    for (size_t multiple = 2; multiple * l3 <= maxBytes; multiple *= 2) {
+        // DRAM-resident sizes, named by their multiple of L3
+        points.push_back({"L3 x" + to_string(multiple), multiple * l3});
+    }
+    erase_if(points, [&](const SweepPoint& point) { return point.bytes > maxBytes; });
+    return points;
+}
+
+// Median seconds per call, repeating small sets until at least minElements were scanned
+template <typename F>
+double medianSecondsPerCall(size_t elements, size_t minElements, F&& scan) {
+    int repeats = static_cast<int>(max<size_t>(5, minElements / max<size_t>(elements, 1)));
+    vector<double> samples(repeats);
+    scan();
+    for (int i = 0; i < repeats; ++i) {
+        samples[i] = measureSeconds(scan);
+    }
+    nth_element(samples.begin(), samples.begin() + repeats / 2, samples.end());
+    return samples[repeats / 2];
+}
+
+void runSweep(size_t maxBytes, size_t minElements, const string& csvPath) {
+    WorkerPool pool(NUM_THREADS, WaitPolicy::Park);
+    ofstream csv;
+    if (!csvPath.empty()) {
+        csv.open(csvPath);
+        csv << "level,bytes,strategy,ns_per_element\n";
+    }
+
+    cout << "[*] Working-set sweep, ns/element\n";
+    cout << left << setw(12) << "Level" << setw(14) << "Bytes" << setw(12) << "Sequential" << setw(12) << "Mutex"
+         << setw(12) << "Atomic" << setw(12) << "Pool" << right << "\n";
+    for (const auto& point : sweepPoints(maxBytes)) {
+        int size = static_cast<int>(point.bytes / sizeof(int));
+        vector<int> data = generateData(size);
+        int count = 0, minElement = 0;
+        atomic atomicCount(0);
+        atomic atomicMinElement(INT_MAX);
+
+        vector<pair<string, double>> timings = {
+            {"sequential", medianSecondsPerCall(size, minElements, [&] {
+                 findDivisibleWithoutParallel(data, count, minElement);
+             })},
+            {"mutex", medianSecondsPerCall(size, minElements, [&] {
+                 findDivisibleWithMutex(data, count, minElement);
+             })},
+            {"atomic", medianSecondsPerCall(size, minElements, [&] {
+                 findDivisibleWithAtomic(data, atomicCount, atomicMinElement);
+             })},
+            {"pool", medianSecondsPerCall(size, minElements, [&] {
+                 findDivisibleWithPool(pool, data, count, minElement);
+             })},
+        };
+
+        cout << left << setw(12) << point.level << setw(14) << point.bytes;
+        for (const auto& [strategy, seconds] : timings) {
+            double nsPerElement = seconds * 1e9 / size;
+            cout << setw(12) << nsPerElement;
+            if (csv.is_open()) {
+                csv << point.level << "," << point.bytes << "," << strategy << "," << nsPerElement << "\n";
+            }
+        }
+        cout << right << endl;
+    }
+    if (csv.is_open()) {
+        cout << "Sweep written to " << csvPath << endl;
+    }
+}
+
+// HDR-style log-linear latency histograms
+// Values below 2^SUB_BUCKET_BITS are exact; above that every power of two is split into
+// 2^(SUB_BUCKET_BITS - 1) linear buckets, so the relative error stays under 1/64
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 7;
+    static constexpr uint64_t LINEAR_LIMIT = 1ull << SUB_BUCKET_BITS;
+    static constexpr uint64_t HALF = LINEAR_LIMIT / 2;
+
+    LatencyHistogram() : counts(LINEAR_LIMIT + (64 - SUB_BUCKET_BITS + 1) * HALF, 0) {}
+
+    void record(uint64_t value) {
+        ++counts[bucketIndex(value)];
+        ++total;
+        maxValue = max(maxValue, value);
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < counts.size(); ++i) {
+            counts[i] += other.counts[i];
+        }
+        total += other.total;
+        maxValue = max(maxValue, other.maxValue);
+    }
+
+    // Highest value equivalent to the bucket holding the given percentile (0..100)
+    uint64_t percentile(double p) const {
+        if (total == 0) {
+            return 0;
+        }
+        uint64_t rank = max<uint64_t>(1, static_cast<uint64_t>(ceil(p / 100.0 * total)));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts.size(); ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return min(maxValue, bucketUpperBound(i));
+            }
+        }
+        return maxValue;
+    }
+
+    uint64_t count() const { return total; }
+    uint64_t maxRecorded() const { return maxValue; }
+
+private:
+    static size_t bucketIndex(uint64_t value) {
+        if (value < LINEAR_LIMIT) {
+            return value;
+        }
+        int shift = (63 - __builtin_clzll(value)) - SUB_BUCKET_BITS + 1;
+        uint64_t top = value >> shift;
+        return LINEAR_LIMIT + (shift - 1) * HALF + (top - HALF);
+    }
+
+    static uint64_t bucketUpperBound(size_t index) {
+        if (index < LINEAR_LIMIT) {
+            return index;
+        }
+        size_t shift = (index - LINEAR_LIMIT) / HALF + 1;
+        uint64_t top = (index - LINEAR_LIMIT) % HALF + HALF;
+        return ((top + 1) << shift) - 1;
+    }
+
+    vector<uint64_t> counts;
+    uint64_t total = 0;
+    uint64_t maxValue = 0;
+};
+
+void printLatencyHistogram(const string& name, const LatencyHistogram& histogram) {
+    cout << "[*] " << name << "\n";
+    cout << "Calls: " << histogram.count() << ", p50: " << histogram.percentile(50) / 1e3
+         << " us, p90: " << histogram.percentile(90) / 1e3 << " us, p99: " << histogram.percentile(99) / 1e3
+         << " us, p99.9: " << histogram.percentile(99.9) / 1e3 << " us, max: " << histogram.maxRecorded() / 1e3
+         << " us" << endl;
+}
+
+// Keeps a result observable so the compiler cannot drop the scan that produced it
+template <typename T>
+void keepAlive(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Every caller thread records into its own histogram; they are merged once the callers finish
+template <typename MakeScan>
+LatencyHistogram recordLatencies(int callers, int callsPerCaller, MakeScan&& makeScan) {
+    LatencyHistogram merged;
+    mutex mergeMutex;
+    vector<thread> threads;
+    for (int c = 0; c < callers; ++c) {
+        threads.emplace_back([&] {
+            LatencyHistogram local;
+            auto scan = makeScan();
+            for (int i = 0; i < callsPerCaller; ++i) {
+                auto start = chrono::steady_clock::now();
+                scan();
+                auto end = chrono::steady_clock::now();
+                local.record(chrono::duration_cast<chrono::nanoseconds>(end - start).count());
+            }
+            lock_guard lock(mergeMutex);
+            merged.merge(local);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return merged;
+}
+
+void runLatencyBenchmark(int size, int calls, int callers) {
+    vector<int> data = generateData(size);
+    int callsPerCaller = max(1, calls / callers);
+
+    printLatencyHistogram("Without parallelization", recordLatencies(callers, callsPerCaller, [&] {
+        return [&] {
+            int count = 0, minElement = 0;
+            findDivisibleWithoutParallel(data, count, minElement);
+            keepAlive(count + minElement);
+        };
+    }));
+    printLatencyHistogram("With mutex", recordLatencies(callers, callsPerCaller, [&] {
+        return [&] {
+            int count = 0, minElement = 0;
+            findDivisibleWithMutex(data, count, minElement);
+            keepAlive(count + minElement);
+        };
+    }));
+    printLatencyHistogram("With atomic variables", recordLatencies(callers, callsPerCaller, [&] {
+        return [&] {
+            atomic atomicCount(0);
+            atomic atomicMinElement(INT_MAX);
+            findDivisibleWithAtomic(data, atomicCount, atomicMinElement);
+            keepAlive(atomicCount.load() + atomicMinElement.load());
+        };
+    }));
+    // WorkerPool::run is not reentrant, so each caller gets its own pool
+    printLatencyHistogram("Worker pool", recordLatencies(callers, callsPerCaller, [&] {
+        return [&, pool = make_shared<WorkerPool>(NUM_THREADS, WaitPolicy::SpinThenPark)] {
+            int count = 0, minElement = 0;
+            findDivisibleWithPool(*pool, data, count, minElement);
+            keepAlive(count + minElement);
+        };
+    }));
+}
+
+// Energy measurement through RAPL powercap counters
+class EnergyMeter {
+public:
+    // Top-level package domains only (intel-rapl:N named package-*); subdomains are already included in
+    // them, and psys, where present, covers the packages as well
+    explicit EnergyMeter(const filesystem::path& root = "/sys/class/powercap") {
+        error_code error;
+        for (const auto& entry : filesystem::directory_iterator(root, error)) {
+            string name = entry.path().filename().string();
+            if (name.rfind("intel-rapl:", 0) != 0 || count(name.begin(), name.end(), ':') != 1) {
+                continue;
+            }
+            string domainName;
+            ifstream nameFile(entry.path() / "name");
+            if (!(nameFile >> domainName) || domainName.rfind("package-", 0) != 0) {
+                continue;
+            }
+            long long energy = 0, range = 0;
+            if (readCounter(entry.path() / "energy_uj", energy) &&
+                readCounter(entry.path() / "max_energy_range_uj", range)) {
+                domains.push_back({entry.path() / "energy_uj", range});
+            }
+        }
+    }
+
+    bool available() const { return !domains.empty(); }
+
+    vector<long long> read() const {
+        vector<long long> readings(domains.size(), 0);
+        for (size_t i = 0; i < domains.size(); ++i) {
+            readCounter(domains[i].energyPath, readings[i]);
+        }
+        return readings;
+    }
+
+    // Counters wrap at max_energy_range_uj
+    double joulesBetween(const vector<long long>& before, const vector<long long>& after) const {
+        long long microjoules = 0;
+        for (size_t i = 0; i < domains.size(); ++i) {
+            long long delta = after[i] - before[i];
+            if (delta < 0) {
+                delta += domains[i].maxRange;
+            }
+            microjoules += delta;
+        }
+        return microjoules / 1e6;
+    }
+
+private:
+    struct Domain {
+        filesystem::path energyPath;
+        long long maxRange;
+    };
+
+    static bool readCounter(const filesystem::path& path, long long& value) {
+        ifstream file(path);
+        return static_cast<bool>(file >> value);
+    }
+
+    vector<Domain> domains;
+};
+
+// Joules consumed while f runs, or a negative value when RAPL is unavailable
+template <typename F>
+double measureJoules(const EnergyMeter& meter, F&& f) {
+    if (!meter.available()) {
+        f();
+        return -1;
+    }
+    auto before = meter.read();
+    f();
+    auto after = meter.read();
+    return meter.joulesBetween(before, after);
+}
+
+void printEnergy(double joules, size_t elements) {
+    if (joules < 0) {
+        cout << "Energy: unavailable (RAPL powercap counters not readable)" << endl;
+        return;
+    }
+    cout << "Energy: " << joules << " J, " << joules * 1e9 / max<size_t>(elements, 1)
+         << " J per billion elements" << endl;
+}
+
+// Memory footprint and page-fault accounting per phase
+struct MemorySnapshot {
+    long rssKb = 0;
+    long peakRssKb = 0;
+    long anonHugePagesKb = 0;
+    long minorFaults = 0;
+    long majorFaults = 0;
+};
+
+// Value in kB of a "Key:   123 kB" line, or 0 when the file or key is missing
+long readProcKb(const string& path, const string& key) {
+    ifstream file(path);
+    string line;
+    while (getline(file, line)) {
+        if (line.rfind(key + ":", 0) == 0) {
+            return stol(line.substr(key.size() + 1));
+        }
+    }
+    return 0;
+}
+
+MemorySnapshot captureMemory() {
+    MemorySnapshot snapshot;
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    snapshot.minorFaults = usage.ru_minflt;
+    snapshot.majorFaults = usage.ru_majflt;
+    snapshot.rssKb = readProcKb("/proc/self/status", "VmRSS");
+    snapshot.peakRssKb = readProcKb("/proc/self/status", "VmHWM");
+    if (snapshot.peakRssKb == 0) {
+        snapshot.peakRssKb = usage.ru_maxrss;
+    }
+    snapshot.anonHugePagesKb = readProcKb("/proc/self/smaps_rollup", "AnonHugePages");
+    return snapshot;
+}
+
+// Resets VmHWM so the next snapshot reports the peak of the current phase only
+bool resetPeakRss() {
+    ofstream file("/proc/self/clear_refs");
+    return static_cast<bool>(file << "5" << flush);
+}
+
+void printMemory(const MemorySnapshot& before, const MemorySnapshot& after, bool peakWasReset) {
+    cout << "Memory: peak RSS " << after.peakRssKb / 1024.0 << " MB" << (peakWasReset ? "" : " (process-wide)")
+         << ", RSS change " << (after.rssKb - before.rssKb) / 1024.0 << " MB"
+         << ", minor faults " << after.minorFaults - before.minorFaults
+         << ", major faults " << after.majorFaults - before.majorFaults
+         << ", huge pages " << after.anonHugePagesKb / 1024.0 << " MB" << endl;
+}
+
+vector<int> generateDataWithReport(int size, const GeneratorOptions& options) {
+    bool peakWasReset = resetPeakRss();
+    auto memoryBefore = captureMemory();
+    vector<int> data;
+    double elapsed = measureSeconds([&] { data = generateData(size, options); });
+    cout << "[*] Data generation\n";
+    cout << "Generated: " << size << " elements, time: " << elapsed << " s" << endl;
+    printMemory(memoryBefore, captureMemory(), peakWasReset);
+    return data;
+}
+
+// Roofline context: read-bandwidth and compute baselines on the same threads as the strategies
+struct RooflineBaseline {
+    bool measured = false;
+    double bytesPerSecond = 0;
+    double elementsPerSecond = 0;
+};
+
+bool rooflineEnabled = false;
+RooflineBaseline roofline;
+
+const int ROOFLINE_REPEATS = 3;
+const int COMPUTE_BUFFER = 4096;
+const int COMPUTE_PASSES = 20000;
+// The bandwidth buffer is this many times the last-level cache, so no pass is served from cache
+const long BANDWIDTH_LLC_MULTIPLE = 4;
+const int READ_LANES = 8;
+
+// STREAM-style read over a buffer well beyond the LLC: independent accumulators let the loop
+// vectorise, so the figure is limited by memory rather than by one dependent add chain
+double measureReadBandwidth() {
+    size_t bytes = BANDWIDTH_LLC_MULTIPLE * cacheSizeBytes(_SC_LEVEL3_CACHE_SIZE, 32 << 20);
+    vector<int> buffer(bytes / sizeof(int), 1);
+    vector<unsigned> sums(NUM_THREADS, 0);
+    double best = 0;
+    size_t size = buffer.size();
+    size_t chunkSize = size / NUM_THREADS / READ_LANES * READ_LANES;
+    for (int repeat = 0; repeat < ROOFLINE_REPEATS; ++repeat) {
+        vector<thread> threads;
+        double elapsed = measureSeconds([&] {
+            for (int i = 0; i < NUM_THREADS; ++i) {
+                size_t start = i * chunkSize;
+                size_t end = (i == NUM_THREADS - 1) ? size : start + chunkSize;
+                threads.emplace_back([&, i, start, end] {
+                    unsigned lanes[READ_LANES] = {};
+                    size_t j = start;
+                    for (; j + READ_LANES <= end; j += READ_LANES) {
+                        for (int lane = 0; lane < READ_LANES; ++lane) {
+                            lanes[lane] += static_cast<unsigned>(buffer[j + lane]);
+                        }
+                    }
+                    unsigned sum = 0;
+                    for (; j < end; ++j) {
+                        sum += static_cast<unsigned>(buffer[j]);
+                    }
+                    for (const auto lane : lanes) {
+                        sum += lane;
+                    }
+                    sums[i] = sum;
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+        });
+        best = max(best, size * sizeof(int) / elapsed);
+    }
+    return best;
+}
+
+// Branch-free divisibility count and min, so the compute baseline pays no mispredictions on any input
+void accumulateDivisibleBranchFree(const int* values, size_t n, int& count, int& minElement) {
+    int localCount = 0;
+    int localMin = INT_MAX;
+    for (size_t i = 0; i < n; ++i) {
+        bool divisible;
+        if constexpr (DIVISOR_IS_ODD) {
+            divisible = static_cast<uint32_t>(values[i]) * DIVISOR_INVERSE + DIVISOR_BIAS <= 2 * DIVISOR_BIAS;
+        } else {
+            divisible = values[i] % DIVISOR == 0;
+        }
+        localCount += divisible;
+        localMin = min(localMin, divisible ? values[i] : INT_MAX);
+    }
+    count += localCount;
+    minElement = min(minElement, localMin);
+}
+
+#if defined(__x86_64__)
+// Same test as selectRange's SIMD paths; the baseline is the widest kernel the CPU runs, not the scalar loop
+__attribute__((target("avx512f")))
+void accumulateDivisibleAvx512(const int* values, size_t n, int& count, int& minElement) {
+    size_t i = 0;
+    if constexpr (DIVISOR_IS_ODD) {
+        const __m512i inverse = _mm512_set1_epi32(static_cast<int>(DIVISOR_INVERSE));
+        const __m512i bias = _mm512_set1_epi32(static_cast<int>(DIVISOR_BIAS));
+        const __m512i limit = _mm512_set1_epi32(static_cast<int>(2 * DIVISOR_BIAS));
+        const __m512i one = _mm512_set1_epi32(1);
+        __m512i counts = _mm512_setzero_si512();
+        __m512i mins = _mm512_set1_epi32(INT_MAX);
+        for (; i + 16 <= n; i += 16) {
+            __m512i value = _mm512_loadu_si512(values + i);
+            __m512i scaled = _mm512_add_epi32(_mm512_mullo_epi32(value, inverse), bias);
+            __mmask16 mask = _mm512_cmple_epu32_mask(scaled, limit);
+            counts = _mm512_mask_add_epi32(counts, mask, counts, one);
+            mins = _mm512_mask_min_epi32(mins, mask, mins, value);
+        }
+        alignas(64) int laneCounts[16];
+        alignas(64) int laneMins[16];
+        _mm512_store_si512(laneCounts, counts);
+        _mm512_store_si512(laneMins, mins);
+        for (int lane = 0; lane < 16; ++lane) {
+            count += laneCounts[lane];
+            minElement = min(minElement, laneMins[lane]);
+        }
+    }
+    accumulateDivisibleBranchFree(values + i, n - i, count, minElement);
+}
+
+__attribute__((target("avx2")))
+void accumulateDivisibleAvx2(const int* values, size_t n, int& count, int& minElement) {
+    size_t i = 0;
+    if constexpr (DIVISOR_IS_ODD) {
+        const __m256i inverse = _mm256_set1_epi32(static_cast<int>(DIVISOR_INVERSE));
+        const __m256i bias = _mm256_set1_epi32(static_cast<int>(DIVISOR_BIAS));
+        const __m256i limit = _mm256_set1_epi32(static_cast<int>(2 * DIVISOR_BIAS));
+        const __m256i none = _mm256_set1_epi32(INT_MAX);
+        __m256i counts = _mm256_setzero_si256();
+        __m256i mins = none;
+        for (; i + 8 <= n; i += 8) {
+            __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+            __m256i scaled = _mm256_add_epi32(_mm256_mullo_epi32(value, inverse), bias);
+            __m256i passed = _mm256_cmpeq_epi32(_mm256_min_epu32(scaled, limit), scaled);
+            counts = _mm256_sub_epi32(counts, passed);
+            mins = _mm256_min_epi32(mins, _mm256_blendv_epi8(none, value, passed));
+        }
+        alignas(32) int laneCounts[8];
+        alignas(32) int laneMins[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(laneCounts), counts);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(laneMins), mins);
+        for (int lane = 0; lane < 8; ++lane) {
+            count += laneCounts[lane];
+            minElement = min(minElement, laneMins[lane]);
+        }
+    }
+    accumulateDivisibleBranchFree(values + i, n - i, count, minElement);
+}
+#endif
+
+using AccumulateFn = void (*)(const int*, size_t, int&, int&);
+
+AccumulateFn resolveComputeKernel() {
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return accumulateDivisibleAvx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return accumulateDivisibleAvx2;
+    }
+#endif
+    return accumulateDivisibleBranchFree;
+}
+
+// Branch-free, vectorised divisibility test on an L1-resident buffer, so memory never limits it
+double measureModuloThroughput() {
+    const AccumulateFn kernel = resolveComputeKernel();
+    vector<int> buffer = generateData(COMPUTE_BUFFER);
+    vector<int> counts(NUM_THREADS, 0);
+    double best = 0;
+    for (int repeat = 0; repeat < ROOFLINE_REPEATS; ++repeat) {
+        vector<thread> threads;
+        double elapsed = measureSeconds([&] {
+            for (int i = 0; i < NUM_THREADS; ++i) {
+                threads.emplace_back([&, i] {
+                    vector<int> local = buffer;
+                    int count = 0, minElement = INT_MAX;
+                    for (int pass = 0; pass < COMPUTE_PASSES; ++pass) {
+                        local[pass % COMPUTE_BUFFER] ^= count & 1;
+                        kernel(local.data(), local.size(), count, minElement);
+                    }
+                    counts[i] = count + minElement;
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+        });
+        best = max(best, static_cast<double>(NUM_THREADS) * COMPUTE_BUFFER * COMPUTE_PASSES / elapsed);
+    }
+    return best;
+}
+
+// Neither baseline depends on the scanned data, so one measurement serves every dataset
+void measureRoofline() {
+    roofline.bytesPerSecond = measureReadBandwidth();
+    roofline.elementsPerSecond = measureModuloThroughput();
+    roofline.measured = true;
+    cout << "[*] Roofline baselines (" << NUM_THREADS << " threads)\n";
+    cout << "Read bandwidth: " << roofline.bytesPerSecond / 1e9 << " GB/s, modulo throughput: "
+         << roofline.elementsPerSecond / 1e9 << " G elements/s, scan ceiling: "
+         << (roofline.bytesPerSecond / sizeof(int) < roofline.elementsPerSecond ? "memory" : "compute") << endl;
+}
+
+double bandwidthFraction(size_t elements, double seconds) {
+    return elements * sizeof(int) / seconds / roofline.bytesPerSecond;
+}
+
+double computeFraction(size_t elements, double seconds) {
+    return elements / seconds / roofline.elementsPerSecond;
+}
+
+void printRoofline(size_t elements, double seconds) {
+    double fractionOfBandwidth = bandwidthFraction(elements, seconds);
+    double fractionOfCompute = computeFraction(elements, seconds);
+    // A fraction above 1 means the baseline is not a ceiling on this machine, so it is flagged, not hidden
+    auto flag = [](double fraction) { return fraction > 1 ? ", above baseline" : ""; };
+    cout << "Roofline: " << elements * sizeof(int) / seconds / 1e9 << " GB/s (" << fractionOfBandwidth * 100
+         << "% of read bandwidth" << flag(fractionOfBandwidth) << "), " << elements / seconds / 1e9
+         << " G elements/s (" << fractionOfCompute * 100 << "% of modulo throughput" << flag(fractionOfCompute)
+         << ")" << endl;
+}
+
+// Results of every strategy run, written as JSON by --json=<file>
+struct StrategyResult {
+    string label;
+    string strategy;
+    size_t elements = 0;
+    int count = 0;
+    int minElement = 0;
+    double seconds = 0;
+    double joules = -1;
+    // File scans only: bytes read from disk per second
+    double bytesPerSecond = -1;
+    MemorySnapshot memoryBefore;
+    MemorySnapshot memoryAfter;
+    ParallelReport parallel;
+};
+
+vector<StrategyResult> strategyResults;
+
+void printParallelReport(const ParallelReport& report) {
+    for (size_t i = 0; i < report.threads.size(); ++i) {
+        const auto& stats = report.threads[i];
+        cout << "Thread " << i << ": busy " << stats.busySeconds << " s, sync " << stats.syncSeconds
+             << " s, elements " << stats.elements << "\n";
+    }
+    cout << "Imbalance (max/mean busy): " << report.imbalance() << ", critical path: " << report.criticalPath()
+         << " s of " << report.wallSeconds << " s wall" << endl;
+}
+
+// scan fills count, minElement and, for parallel strategies, the per-thread report
+template <typename F>
+void runStrategy(const string& label, const string& name, size_t elements, const EnergyMeter& energy, F&& scan) {
+    StrategyResult result;
+    result.label = label;
+    result.strategy = name;
+    result.elements = elements;
+    bool peakWasReset = resetPeakRss();
+    result.memoryBefore = captureMemory();
+    result.joules = measureJoules(energy, [&] {
+        result.seconds = measureSeconds([&] { scan(result.count, result.minElement, result.parallel); });
+    });
+    result.memoryAfter = captureMemory();
+
+    cout << "[*] " << name << "\n";
+    cout << "Found: " << result.count << " elements, minimum: " << result.minElement
+         << ", time: " << result.seconds << " s" << endl;
+    if (!result.parallel.threads.empty()) {
+        printParallelReport(result.parallel);
+    }
+    if (roofline.measured) {
+        printRoofline(elements, result.seconds);
+    }
+    printEnergy(result.joules, elements);
+    printMemory(result.memoryBefore, result.memoryAfter, peakWasReset);
+    strategyResults.push_back(std::move(result));
+}
+
+void runStrategies(const vector<int>& data, const string& label = "uniform") {
+    EnergyMeter energy;
+    if (rooflineEnabled && !roofline.measured) {
+        measureRoofline();
+    }
+
+    // Without parallelization
+    runStrategy(label, "Without parallelization", data.size(), energy,
+                [&](int& count, int& minElement, ParallelReport&) {
+                    findDivisibleWithoutParallel(data, count, minElement);
+                });
+
+    // With mutex
+    runStrategy(label, "With mutex", data.size(), energy,
+                [&](int& count, int& minElement, ParallelReport& report) {
+                    findDivisibleWithMutex(data, count, minElement, &report);
+                });
+
+    // With atomic variables
+    runStrategy(label, "With atomic variables", data.size(), energy,
+                [&](int& count, int& minElement, ParallelReport& report) {
+                    atomic atomicCount(0);
+                    atomic atomicMinElement(INT_MAX);
+                    findDivisibleWithAtomic(data, atomicCount, atomicMinElement, &report);
+                    count = atomicCount.load();
+                    minElement = atomicMinElement.load();
+                });
+}
+
+// Labels can be file or directory paths, so quotes, backslashes and control characters are escaped
+string jsonEscape(const string& text) {
+    ostringstream escaped;
+    for (char c : text) {
+        switch (c) {
+            case '"': escaped << "\\\""; break;
+            case '\\': escaped << "\\\\"; break;
+            case '\n': escaped << "\\n"; break;
+            case '\r': escaped << "\\r"; break;
+            case '\t': escaped << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    escaped << "\\u" << hex << setw(4) << setfill('0') << static_cast<int>(c) << dec;
+                } else {
+                    escaped << c;
+                }
+        }
+    }
+    return escaped.str();
+}
+
+bool writeJsonResults(const string& path) {
+    ofstream file(path);
+    file << "{\"divisor\":" << DIVISOR << ",\"threads\":" << NUM_THREADS;
+    if (roofline.measured) {
+        file << ",\"readBandwidthBytesPerSecond\":" << roofline.bytesPerSecond
+             << ",\"moduloElementsPerSecond\":" << roofline.elementsPerSecond;
+    }
+    file << ",\"results\":[";
+    for (size_t i = 0; i < strategyResults.size(); ++i) {
+        const auto& result = strategyResults[i];
+        const auto& parallel = result.parallel;
+        file << (i == 0 ? "\n" : ",\n") << "{\"label\":\"" << jsonEscape(result.label) << "\",\"strategy\":\""
+             << jsonEscape(result.strategy) << "\",\"elements\":" << result.elements << ",\"count\":" << result.count
+             << ",\"minElement\":" << result.minElement << ",\"seconds\":" << result.seconds;
+        if (result.joules >= 0) {
+            file << ",\"joules\":" << result.joules;
+        }
+        if (result.bytesPerSecond >= 0) {
+            file << ",\"bytesPerSecond\":" << result.bytesPerSecond;
+        }
+        if (roofline.measured) {
+            file << ",\"bandwidthFraction\":" << bandwidthFraction(result.elements, result.seconds)
+                 << ",\"computeFraction\":" << computeFraction(result.elements, result.seconds);
+        }
+        file << ",\"memory\":{\"peakRssKb\":" << result.memoryAfter.peakRssKb
+             << ",\"minorFaults\":" << result.memoryAfter.minorFaults - result.memoryBefore.minorFaults
+             << ",\"majorFaults\":" << result.memoryAfter.majorFaults - result.memoryBefore.majorFaults
+             << ",\"anonHugePagesKb\":" << result.memoryAfter.anonHugePagesKb << "}";
+        if (!parallel.threads.empty()) {
+            file << ",\"imbalance\":" << parallel.imbalance() << ",\"criticalPathSeconds\":" << parallel.criticalPath()
+                 << ",\"wallSeconds\":" << parallel.wallSeconds << ",\"threadStats\":[";
+            for (size_t t = 0; t < parallel.threads.size(); ++t) {
+                const auto& stats = parallel.threads[t];
+                file << (t == 0 ? "" : ",") << "{\"busySeconds\":" << stats.busySeconds
+                     << ",\"syncSeconds\":" << stats.syncSeconds << ",\"elements\":" << stats.elements << "}";
+            }
+            file << "]";
+        }
+        file << "}";
+    }
+    file << "\n]}\n";
+    return static_cast<bool>(file);
+}
+
+// Out-of-core scans of a raw file of native ints: buffered reads, mmap and O_DIRECT
+const size_t DIRECT_IO_ALIGNMENT = 4096;
+
+bool writeDataFile(const string& path, int size) {
+    vector<int> data = generateData(size);
+    ofstream file(path, ios::binary | ios::trunc);
+    file.write(reinterpret_cast<const char*>(data.data()), static_cast<streamsize>(data.size() * sizeof(int)));
+    return static_cast<bool>(file);
+}
+
+// Writes back and drops the file's pages, so every method starts from a cold cache
+void dropPageCache(int fd) {
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+}
+
+// Fraction of the file's pages currently in the page cache, or -1 when it cannot be determined
+double residentFraction(int fd, size_t bytes) {
+    if (bytes == 0) {
+        return 0;
+    }
+    void* mapping = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        return -1;
+    }
+    const size_t pageSize = sysconf(_SC_PAGESIZE);
+    vector<unsigned char> pages((bytes + pageSize - 1) / pageSize);
+    double result = -1;
+    if (mincore(mapping, bytes, pages.data()) == 0) {
+        size_t resident = count_if(pages.begin(), pages.end(), [](unsigned char page) { return page & 1; });
+        result = static_cast<double>(resident) / pages.size();
+    }
+    munmap(mapping, bytes);
+    return result;
+}
+
+// Every worker gets a contiguous run of whole blocks; scanRange(index, begin, end, stats) reads bytes [begin, end)
+template <typename F>
+bool scanFileParallel(size_t fileBytes, size_t blockSize, int& count, int& minElement, ParallelReport& report,
+                      F&& scanRange) {
+    const size_t blocks = (fileBytes + blockSize - 1) / blockSize;
+    vector<WorkerResult> local(NUM_THREADS);
+    vector<ThreadStats> stats(NUM_THREADS);
+    atomic ok(true);
+    vector<thread> threads;
+    auto wallStart = chrono::steady_clock::now();
+
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        size_t begin = blocks * i / NUM_THREADS * blockSize;
+        size_t end = min(fileBytes, blocks * (i + 1) / NUM_THREADS * blockSize);
+        threads.emplace_back([&, i, begin, end] {
+            TraceSpan chunkSpan("file chunk");
+            chunkSpan.setArg("bytes", static_cast<long long>(end - begin));
+            auto busyStart = chrono::steady_clock::now();
+            if (begin < end && !scanRange(i, begin, end, local[i])) {
+                ok = false;
+            }
+            stats[i] = {secondsBetween(busyStart, chrono::steady_clock::now()), 0,
+                        static_cast<long long>((end - begin) / sizeof(int))};
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    count = 0;
+    minElement = INT_MAX;
+    for (const auto& result : local) {
+        count += result.count;
+        minElement = min(minElement, result.minElement);
+    }
+    report.threads = std::move(stats);
+    report.wallSeconds = secondsBetween(wallStart, chrono::steady_clock::now());
+    return ok;
+}
+
+bool scanRangeBuffered(int fd, size_t begin, size_t end, size_t blockSize, SegmentStats& stats) {
+    vector<int> buffer(blockSize / sizeof(int));
+    for (size_t offset = begin; offset < end;) {
+        ssize_t bytes = pread(fd, buffer.data(), min(blockSize, end - offset), static_cast<off_t>(offset));
+        if (bytes <= 0) {
+            if (bytes < 0 && errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        accumulateDivisible(buffer.data(), bytes / sizeof(int), stats.count, stats.minElement);
+        offset += bytes;
+    }
+    return true;
+}
+
+// Keeps queueDepth aligned reads in flight through kernel AIO and scans each block as it lands,
+// so the device works on the next reads while this thread runs the kernel
+bool scanRangeDirect(int fd, size_t begin, size_t end, size_t blockSize, int queueDepth, SegmentStats& stats) {
+    vector<unique_ptr<int, decltype(&free)>> buffers;
+    for (int slot = 0; slot < queueDepth; ++slot) {
+        buffers.emplace_back(static_cast<int*>(aligned_alloc(DIRECT_IO_ALIGNMENT, blockSize)), &free);
+        if (buffers.back() == nullptr) {
+            cerr << "Cannot allocate " << blockSize << " byte aligned read buffers" << endl;
+            return false;
+        }
+    }
+    aio_context_t context = 0;
+    if (syscall(SYS_io_setup, queueDepth, &context) < 0) {
+        return false;
+    }
+    vector<iocb> requests(queueDepth);
+    size_t next = begin;
+    int inFlight = 0;
+    bool ok = true;
+
+    // O_DIRECT needs aligned lengths; the read of the file's last block just comes back short
+    auto submit = [&](int slot) {
+        requests[slot] = {};
+        requests[slot].aio_fildes = fd;
+        requests[slot].aio_lio_opcode = IOCB_CMD_PREAD;
+        requests[slot].aio_buf = reinterpret_cast<uint64_t>(buffers[slot].get());
+        requests[slot].aio_nbytes = blockSize;
+        requests[slot].aio_offset = static_cast<int64_t>(next);
+        requests[slot].aio_data = slot;
+        iocb* request = &requests[slot];
+        if (syscall(SYS_io_submit, context, 1, &request) != 1) {
+            return false;
+        }
+        next += blockSize;
+        ++inFlight;
+        return true;
+    };
+
+    for (int slot = 0; slot < queueDepth && next < end && ok; ++slot) {
+        ok = submit(slot);
+    }
+    vector<io_event> events(queueDepth);
+    while (inFlight > 0) {
+        long completed = syscall(SYS_io_getevents, context, 1, queueDepth, events.data(), nullptr);
+        if (completed < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ok = false;
+            break;
+        }
+        for (long e = 0; e < completed; ++e) {
+            --inFlight;
+            int slot = static_cast<int>(events[e].data);
+            if (events[e].res < 0) {
+                ok = false;
+                continue;
+            }
+            size_t offset = static_cast<size_t>(requests[slot].aio_offset);
+            size_t bytes = min(static_cast<size_t>(events[e].res), end - offset);
+            accumulateDivisible(buffers[slot].get(), bytes / sizeof(int), stats.count, stats.minElement);
+            if (ok && next < end) {
+                ok = submit(slot);
+            }
+        }
+    }
+    // Waits for anything still in flight after an error before the buffers are freed
+    syscall(SYS_io_destroy, context);
+    return ok;
+}
+
+// Reports the throughput of the file scan just recorded by runStrategy, then page-cache residency
+void printFileScan(int fd, size_t fileBytes) {
+    auto& result = strategyResults.back();
+    if (result.seconds > 0) {
+        result.bytesPerSecond = fileBytes / result.seconds;
+        cout << "Throughput: " << result.bytesPerSecond / 1e9 << " GB/s" << endl;
+    }
+    double resident = residentFraction(fd, fileBytes);
+    if (resident >= 0) {
+        cout << "Page cache: " << resident * 100 << "% of the file resident after the scan" << endl;
+    }
+}
+
+int runFileBenchmark(const string& path, int size, size_t blockSize, int queueDepth) {
+    if (size > 0 && !writeDataFile(path, size)) {
+        cerr << "Cannot write " << path << endl;
+        return 1;
+    }
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        cerr << "Cannot open " << path << endl;
+        return 1;
+    }
+    struct stat fileStat {};
+    fstat(fd, &fileStat);
+    const size_t fileBytes = static_cast<size_t>(fileStat.st_size) / sizeof(int) * sizeof(int);
+    const size_t elements = fileBytes / sizeof(int);
+    cout << "[*] Scanning " << path << ": " << elements << " elements, " << blockSize / 1024 << " KB blocks, "
+         << queueDepth << " reads in flight per O_DIRECT worker" << endl;
+
+    EnergyMeter energy;
+    bool ok = true;
+
+    dropPageCache(fd);
+    runStrategy(path, "Buffered reads", elements, energy, [&](int& count, int& minElement, ParallelReport& report) {
+        ok = scanFileParallel(fileBytes, blockSize, count, minElement, report,
+                              [&](int, size_t begin, size_t end, SegmentStats& stats) {
+                                  return scanRangeBuffered(fd, begin, end, blockSize, stats);
+                              }) && ok;
+    });
+    printFileScan(fd, fileBytes);
+
+    dropPageCache(fd);
+    runStrategy(path, "mmap", elements, energy, [&](int& count, int& minElement, ParallelReport& report) {
+        void* mapping = fileBytes > 0 ? mmap(nullptr, fileBytes, PROT_READ, MAP_SHARED, fd, 0) : nullptr;
+        if (mapping == MAP_FAILED) {
+            ok = false;
+            return;
+        }
+        const int* values = static_cast<const int*>(mapping);
+        ok = scanFileParallel(fileBytes, blockSize, count, minElement, report,
+                              [&](int, size_t begin, size_t end, SegmentStats& stats) {
+                                  madvise(const_cast<int*>(values) + begin / sizeof(int), end - begin,
+                                          MADV_SEQUENTIAL);
+                                  accumulateDivisible(values + begin / sizeof(int), (end - begin) / sizeof(int),
+                                                      stats.count, stats.minElement);
+                                  return true;
+                              }) && ok;
+        if (mapping != nullptr) {
+            munmap(mapping, fileBytes);
+        }
+    });
+    printFileScan(fd, fileBytes);
+
+    dropPageCache(fd);
+    int directFd = open(path.c_str(), O_RDONLY | O_DIRECT);
+    if (directFd < 0) {
+        cerr << "O_DIRECT is not supported for " << path << ", skipping" << endl;
+    } else {
+        runStrategy(path, "O_DIRECT", elements, energy, [&](int& count, int& minElement, ParallelReport& report) {
+            ok = scanFileParallel(fileBytes, blockSize, count, minElement, report,
+                                  [&](int, size_t begin, size_t end, SegmentStats& stats) {
+                                      return scanRangeDirect(directFd, begin, end, blockSize, queueDepth, stats);
+                                  }) && ok;
+        });
+        printFileScan(fd, fileBytes);
+        close(directFd);
+    }
+    close(fd);
+
+    if (!ok) {
+        cerr << "I/O error while scanning " << path << endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Sharded datasets: a directory of raw int files, or a manifest listing them
+const size_t SHARD_READ_BYTES = 1 << 20;
+
+struct Shard {
+    string path;
+    size_t bytes = 0;
+};
+
+// Byte range [begin, end) of one shard
+struct ShardTask {
+    int shard = 0;
+    size_t begin = 0;
+    size_t end = 0;
+};
+
+// Shard files carry this extension, so a manifest or notes kept next to them are not scanned as data
+const string SHARD_EXTENSION = ".bin";
+
+// Manifest lines are shard paths relative to the manifest's directory; blank lines and # comments are skipped
+bool listShards(const string& source, vector<Shard>& shards) {
+    shards.clear();
+    if (filesystem::is_directory(source)) {
+        for (const auto& entry : filesystem::directory_iterator(source)) {
+            if (entry.is_regular_file() && entry.path().extension() == SHARD_EXTENSION) {
+                shards.push_back({entry.path().string(), 0});
+            }
+        }
+        sort(shards.begin(), shards.end(), [](const Shard& a, const Shard& b) { return a.path < b.path; });
+    } else {
+        ifstream manifest(source);
+        if (!manifest) {
+            cerr << "Cannot open " << source << endl;
+            return false;
+        }
+        filesystem::path base = filesystem::path(source).parent_path();
+        string line;
+        while (getline(manifest, line)) {
+            line.erase(line.find_last_not_of(" \t\r") + 1);
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            filesystem::path path(line);
+            shards.push_back({(path.is_relative() ? base / path : path).string(), 0});
+        }
+    }
+
+    for (auto& shard : shards) {
+        error_code error;
+        uintmax_t bytes = filesystem::file_size(shard.path, error);
+        if (error) {
+            cerr << "Cannot read shard " << shard.path << ": " << error.message() << endl;
+            return false;
+        }
+        shard.bytes = bytes / sizeof(int) * sizeof(int);
+    }
+    return true;
+}
+
+// Shards larger than taskBytes are cut into pieces; the largest tasks go first, so long ones start
+// early and the small ones fill the gaps at the end (longest-processing-time-first scheduling)
+vector<ShardTask> planShardTasks(const vector<Shard>& shards, size_t taskBytes) {
+    vector<ShardTask> tasks;
+    for (int i = 0; i < static_cast<int>(shards.size()); ++i) {
+        for (size_t begin = 0; begin < shards[i].bytes; begin += taskBytes) {
+            tasks.push_back({i, begin, min(shards[i].bytes, begin + taskBytes)});
+        }
+    }
+    stable_sort(tasks.begin(), tasks.end(), [](const ShardTask& a, const ShardTask& b) {
+        return a.end - a.begin > b.end - b.begin;
+    });
+    return tasks;
+}
+
+// Workers claim tasks in order from a shared cursor and keep their own count/min, merged after the run
+bool findDivisibleInShards(WorkerPool& pool, const vector<Shard>& shards, const vector<ShardTask>& tasks,
+                           int& count, int& minElement, ParallelReport& report) {
+    const int workers = pool.size();
+    vector<WorkerResult> local(workers);
+    vector<ThreadStats> stats(workers);
+    atomic<size_t> nextTask(0);
+    atomic ok(true);
+    auto wallStart = chrono::steady_clock::now();
+
+    pool.run([&](const int index) {
+        auto busyStart = chrono::steady_clock::now();
+        long long elements = 0;
+        for (size_t t = nextTask.fetch_add(1); t < tasks.size(); t = nextTask.fetch_add(1)) {
+            const ShardTask& task = tasks[t];
+            TraceSpan taskSpan("shard task");
+            taskSpan.setArg("shard", task.shard);
+            taskSpan.setArg("bytes", static_cast<long long>(task.end - task.begin));
+            // Opened per task, so hundreds of shards never hold hundreds of descriptors
+            int fd = open(shards[task.shard].path.c_str(), O_RDONLY);
+            if (fd < 0 || !scanRangeBuffered(fd, task.begin, task.end, SHARD_READ_BYTES, local[index])) {
+                ok = false;
+            }
+            if (fd >= 0) {
+                close(fd);
+            }
+            elements += static_cast<long long>((task.end - task.begin) / sizeof(int));
+        }
+        stats[index] = {secondsBetween(busyStart, chrono::steady_clock::now()), 0, elements};
+    });
+
+    count = 0;
+    minElement = INT_MAX;
+    for (const auto& result : local) {
+        count += result.count;
+        minElement = min(minElement, result.minElement);
+    }
+    report.threads = std::move(stats);
+    report.wallSeconds = secondsBetween(wallStart, chrono::steady_clock::now());
+    return ok;
+}
+
+// Both layouts start from a cold cache, so the second run does not read what the first one cached
+void dropShardCaches(const vector<Shard>& shards) {
+    for (const auto& shard : shards) {
+        int fd = open(shard.path.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            dropPageCache(fd);
+            close(fd);
+        }
+    }
+}
+
+// Shard sizes are exponentially distributed around averageSize, so a few shards dominate
+bool writeShardDirectory(const string& directory, int shardCount, int averageSize) {
+    error_code error;
+    filesystem::create_directories(directory, error);
+    mt19937 gen(7);
+    exponential_distribution<double> sizeDist(1.0 / max(1, averageSize));
+    for (int i = 0; i < shardCount; ++i) {
+        ostringstream name;
+        name << "shard-" << setw(5) << setfill('0') << i << SHARD_EXTENSION;
+        int size = max(1, static_cast<int>(min(sizeDist(gen), static_cast<double>(INT_MAX / 2))));
+        if (!writeDataFile((filesystem::path(directory) / name.str()).string(), size)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int runShardBenchmark(const string& source, int shardCount, int averageSize) {
+    if (shardCount > 0 && !writeShardDirectory(source, shardCount, averageSize)) {
+        cerr << "Cannot write shards to " << source << endl;
+        return 1;
+    }
+    vector<Shard> shards;
+    if (!listShards(source, shards)) {
+        return 1;
+    }
+    size_t totalBytes = 0;
+    size_t largestShard = 0;
+    for (const auto& shard : shards) {
+        totalBytes += shard.bytes;
+        largestShard = max(largestShard, shard.bytes);
+    }
+    const size_t elements = totalBytes / sizeof(int);
+
+    // About eight tasks per worker, never smaller than one read
+    size_t taskBytes = max(SHARD_READ_BYTES, totalBytes / (NUM_THREADS * 8));
+    taskBytes = (taskBytes + SHARD_READ_BYTES - 1) / SHARD_READ_BYTES * SHARD_READ_BYTES;
+    vector<ShardTask> wholeShards;
+    for (int i = 0; i < static_cast<int>(shards.size()); ++i) {
+        wholeShards.push_back({i, 0, shards[i].bytes});
+    }
+    vector<ShardTask> tasks = planShardTasks(shards, taskBytes);
+    cout << "[*] " << shards.size() << " shards, " << elements << " elements, largest shard "
+         << largestShard / 1024 << " KB; " << tasks.size() << " tasks of up to " << taskBytes / 1024 << " KB"
+         << endl;
+
+    WorkerPool pool(NUM_THREADS, WaitPolicy::Park);
+    EnergyMeter energy;
+    bool ok = true;
+    dropShardCaches(shards);
+    runStrategy(source, "Whole shards, listing order", elements, energy,
+                [&](int& count, int& minElement, ParallelReport& report) {
+                    ok = findDivisibleInShards(pool, shards, wholeShards, count, minElement, report) && ok;
+                });
+    dropShardCaches(shards);
+    runStrategy(source, "Split shards, largest first", elements, energy,
+                [&](int& count, int& minElement, ParallelReport& report) {
+                    ok = findDivisibleInShards(pool, shards, tasks, count, minElement, report) && ok;
+                });
+
+    if (!ok) {
+        cerr << "I/O error while scanning " << source << endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Prometheus text-format metrics for long-running mode
+const int LATENCY_BUCKETS = 16;
+
+// Hot path cost is a handful of relaxed atomic adds per scan; formatting happens on the exporter thread
+class ScanMetrics {
+public:
+    explicit ScanMetrics(string strategy) : strategy(std::move(strategy)) {}
+
+    void recordScan(size_t elements, double seconds, const ParallelReport* report) {
+        scans.fetch_add(1, memory_order_relaxed);
+        elementsScanned.fetch_add(elements, memory_order_relaxed);
+        latencySumNs.fetch_add(static_cast<uint64_t>(seconds * 1e9), memory_order_relaxed);
+        int bucket = 0;
+        while (bucket < LATENCY_BUCKETS && seconds > bucketBound(bucket)) {
+            ++bucket;
+        }
+        latencyBuckets[bucket].fetch_add(1, memory_order_relaxed);
+
+        if (report != nullptr) {
+            uint64_t busy = 0, sync = 0;
+            for (const auto& stats : report->threads) {
+                busy += static_cast<uint64_t>(stats.busySeconds * 1e9);
+                sync += static_cast<uint64_t>(stats.syncSeconds * 1e9);
+            }
+            workerBusyNs.fetch_add(busy, memory_order_relaxed);
+            lockWaitNs.fetch_add(sync, memory_order_relaxed);
+            workerCapacityNs.fetch_add(static_cast<uint64_t>(report->wallSeconds * 1e9) * report->threads.size(),
+                                       memory_order_relaxed);
+        }
+    }
+
+    // Upper bounds 100 us, 200 us, ... doubling up to about 3.3 s
+    static double bucketBound(int bucket) {
+        return 1e-4 * (1 << bucket);
+    }
+
+    string render() const {
+        ostringstream out;
+        string label = "{strategy=\"" + strategy + "\"}";
+        uint64_t elements = elementsScanned.load(memory_order_relaxed);
+        uint64_t capacity = workerCapacityNs.load(memory_order_relaxed);
+
+        out << "# HELP divscan_scans_total Scans executed.\n# TYPE divscan_scans_total counter\n"
+            << "divscan_scans_total" << label << " " << scans.load(memory_order_relaxed) << "\n";
+        out << "# HELP divscan_elements_scanned_total Elements scanned.\n# TYPE divscan_elements_scanned_total counter\n"
+            << "divscan_elements_scanned_total" << label << " " << elements << "\n";
+        out << "# HELP divscan_bytes_read_total Bytes of input read.\n# TYPE divscan_bytes_read_total counter\n"
+            << "divscan_bytes_read_total" << label << " " << elements * sizeof(int) << "\n";
+        out << "# HELP divscan_lock_wait_seconds_total Time workers spent in the mutex or CAS merge.\n"
+            << "# TYPE divscan_lock_wait_seconds_total counter\n"
+            << "divscan_lock_wait_seconds_total" << label << " " << lockWaitNs.load(memory_order_relaxed) / 1e9 << "\n";
+        out << "# HELP divscan_worker_utilization Busy share of worker wall time.\n"
+            << "# TYPE divscan_worker_utilization gauge\n"
+            << "divscan_worker_utilization" << label << " "
+            << (capacity > 0 ? static_cast<double>(workerBusyNs.load(memory_order_relaxed)) / capacity : 0) << "\n";
+
+        out << "# HELP divscan_scan_latency_seconds Scan latency.\n# TYPE divscan_scan_latency_seconds histogram\n";
+        uint64_t cumulative = 0;
+        for (int bucket = 0; bucket <= LATENCY_BUCKETS; ++bucket) {
+            cumulative += latencyBuckets[bucket].load(memory_order_relaxed);
+            out << "divscan_scan_latency_seconds_bucket{strategy=\"" << strategy << "\",le=\"";
+            if (bucket < LATENCY_BUCKETS) {
+                out << bucketBound(bucket);
+            } else {
+                out << "+Inf";
+            }
+            out << "\"} " << cumulative << "\n";
+        }
+        out << "divscan_scan_latency_seconds_sum" << label << " " << latencySumNs.load(memory_order_relaxed) / 1e9 << "\n"
+            << "divscan_scan_latency_seconds_count" << label << " " << cumulative << "\n";
+        return out.str();
+    }
+
+private:
+    string strategy;
+    atomic<uint64_t> scans{0};
+    atomic<uint64_t> elementsScanned{0};
+    atomic<uint64_t> latencySumNs{0};
+    atomic<uint64_t> lockWaitNs{0};
+    atomic<uint64_t> workerBusyNs{0};
+    atomic<uint64_t> workerCapacityNs{0};
+    array<atomic<uint64_t>, LATENCY_BUCKETS + 1> latencyBuckets{};
+};
+
+// Renders the metrics every interval into a file (written then renamed, so scrapers never see a
+// partial file) or, for a ":port" target, into a snapshot served over HTTP on 127.0.0.1
+class MetricsExporter {
+public:
+    MetricsExporter(const ScanMetrics& metrics, string target, chrono::milliseconds interval)
+        : metrics(metrics), target(std::move(target)), interval(interval) {
+        snapshot = metrics.render();
+        if (!this->target.empty() && this->target[0] == ':') {
+            listenSocket = openListenSocket(stoi(this->target.substr(1)));
+            if (listenSocket >= 0) {
+                server = thread(&MetricsExporter::serve, this);
+            }
+        }
+        renderer = thread(&MetricsExporter::renderLoop, this);
+    }
+
+    ~MetricsExporter() {
+        stopping.store(true);
+        renderer.join();
+        if (server.joinable()) {
+            server.join();
+        }
+        if (listenSocket >= 0) {
+            close(listenSocket);
+        }
+    }
+
+    bool listening() const { return listenSocket >= 0; }
+
+private:
+    static int openListenSocket(int port) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) {
+            return -1;
+        }
+        int reuse = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(port));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(fd, 16) < 0) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    void publish() {
+        string text = metrics.render();
+        if (listenSocket >= 0) {
+            lock_guard lock(snapshotMutex);
+            snapshot = std::move(text);
+            return;
+        }
+        string temporary = target + ".tmp";
+        {
+            ofstream file(temporary);
+            file << text;
+        }
+        rename(temporary.c_str(), target.c_str());
+    }
+
+    void renderLoop() {
+        while (!stopping.load()) {
+            publish();
+            for (auto waited = chrono::milliseconds(0); waited < interval && !stopping.load();
+                 waited += chrono::milliseconds(10)) {
+                this_thread::sleep_for(chrono::milliseconds(10));
+            }
+        }
+        publish();
+    }
+
+    void serve() {
+        while (!stopping.load()) {
+            pollfd descriptor{listenSocket, POLLIN, 0};
+            if (poll(&descriptor, 1, 100) <= 0) {
+                continue;
+            }
+            int client = accept(listenSocket, nullptr, nullptr);
+            if (client < 0) {
+                continue;
+            }
+            char request[1024];
+            (void)!read(client, request, sizeof(request));
+            string body;
+            {
+                lock_guard lock(snapshotMutex);
+                body = snapshot;
+            }
+            string response = "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " +
+                              to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+            (void)!write(client, response.data(), response.size());
+            close(client);
+        }
+    }
+
+    const ScanMetrics& metrics;
+    string target;
+    chrono::milliseconds interval;
+    atomic<bool> stopping{false};
+    int listenSocket = -1;
+    mutex snapshotMutex;
+    string snapshot;
+    thread renderer;
+    thread server;
+};
+
+// Scans the same data in a loop, as a long-lived service would, exporting metrics as it goes
+int runServe(const string& target, int size, const string& strategy, int intervalMs, int seconds) {
+    if (strategy != "sequential" && strategy != "mutex" && strategy != "atomic") {
+        cerr << "Unknown strategy: " << strategy << endl;
+        return 1;
+    }
+    vector<int> data = generateData(size);
+    ScanMetrics metrics(strategy);
+    MetricsExporter exporter(metrics, target, chrono::milliseconds(intervalMs));
+    if (target[0] == ':' && !exporter.listening()) {
+        cerr << "Cannot listen on 127.0.0.1" << target << endl;
+        return 1;
+    }
+    cout << "[*] Serving " << strategy << " scans, metrics at " << target << " every " << intervalMs << " ms" << endl;
+
+    auto deadline = chrono::steady_clock::now() + chrono::seconds(seconds);
+    while (seconds <= 0 || chrono::steady_clock::now() < deadline) {
+        int count = 0, minElement = 0;
+        ParallelReport report;
+        double elapsed = measureSeconds([&] {
+            if (strategy == "sequential") {
+                findDivisibleWithoutParallel(data, count, minElement);
+            } else if (strategy == "mutex") {
+                findDivisibleWithMutex(data, count, minElement, &report);
+            } else {
+                atomic atomicCount(0);
+                atomic atomicMinElement(INT_MAX);
+                findDivisibleWithAtomic(data, atomicCount, atomicMinElement, &report);
+            }
+        });
+        metrics.recordScan(data.size(), elapsed, strategy == "sequential" ? nullptr : &report);
+    }
+    return 0;
+}
+
+// Benchmark history with noise-aware regression detection
+struct HistoryEntry {
+    long long timestamp = 0;
+    string host;
+    string config;
+    string strategy;
+    double median = 0;
+    // Median absolute deviation relative to the median
+    double spread = 0;
+};
+
+string hostFingerprint() {
+    char hostname[256] = {};
+    gethostname(hostname, sizeof(hostname) - 1);
+    string cpuModel = "unknown";
+    ifstream cpuinfo("/proc/cpuinfo");
+    string line;
+    while (getline(cpuinfo, line)) {
+        if (line.rfind("model name", 0) == 0) {
+            cpuModel = line.substr(line.find(':') + 2);
+            break;
+        }
+    }
+    // FNV-1a rather than std::hash, so fingerprints stay comparable across builds
+    uint64_t hashValue = 1469598103934665603ull;
+    for (char c : string(hostname) + "|" + cpuModel + "|" + to_string(thread::hardware_concurrency())) {
+        hashValue = (hashValue ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+    ostringstream fingerprint;
+    fingerprint << hex << hashValue;
+    return fingerprint.str();
+}
+
+// One tab-separated entry per line: timestamp, host, config, strategy, median seconds, spread
+vector<HistoryEntry> loadHistory(const string& path) {
+    vector<HistoryEntry> entries;
+    ifstream file(path);
+    string line;
+    int lineNumber = 0;
+    while (getline(file, line)) {
+        ++lineNumber;
+        istringstream fields(line);
+        HistoryEntry entry;
+        string timestamp, median, spread;
+        bool valid = getline(fields, timestamp, '\t') && getline(fields, entry.host, '\t') &&
+                     getline(fields, entry.config, '\t') && getline(fields, entry.strategy, '\t') &&
+                     getline(fields, median, '\t') && getline(fields, spread, '\t');
+        // Truncated or hand-edited lines are skipped rather than failing the whole check
+        try {
+            if (valid) {
+                entry.timestamp = stoll(timestamp);
+                entry.median = stod(median);
+                entry.spread = stod(spread);
+            }
+        } catch (const exception&) {
+            valid = false;
+        }
+        // A zero median cannot serve as a baseline
+        valid = valid && isfinite(entry.median) && entry.median > 0 && isfinite(entry.spread) && entry.spread >= 0;
+        if (valid) {
+            entries.push_back(entry);
+        } else if (!line.empty()) {
+            cerr << "Skipping malformed history line " << lineNumber << " in " << path << endl;
+        }
+    }
+    return entries;
+}
+
+double medianOf(vector<double> values) {
+    nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+    return values[values.size() / 2];
+}
+
+HistoryEntry measureForHistory(const string& strategy, int repeats, const function<void()>& scan) {
+    vector<double> samples(repeats);
+    scan();
+    for (int i = 0; i < repeats; ++i) {
+        samples[i] = measureSeconds(scan);
+    }
+    HistoryEntry entry;
+    entry.strategy = strategy;
+    entry.median = medianOf(samples);
+    vector<double> deviations;
+    for (double sample : samples) {
+        deviations.push_back(abs(sample - entry.median));
+    }
+    // Scans too short for the clock can have a zero median
+    entry.spread = entry.median > 0 ? medianOf(deviations) / entry.median : 0;
+    return entry;
+}
+
+// -march=native changes the codegen of every strategy, so runs with and without it are not comparable
+#if defined(DIVSCAN_NATIVE)
+const bool NATIVE_BUILD = true;
+#else
+const bool NATIVE_BUILD = false;
+#endif
+
+// A run regresses when its median exceeds the baseline (median of earlier medians for the same
+// host, config and strategy) by more than the larger of minThreshold and three combined spreads
+int runHistoryCheck(const string& path, int size, int repeats, double minThreshold) {
+    vector<int> data = generateData(size);
+    string host = hostFingerprint();
+    string config = "elements=" + to_string(size) + ",threads=" + to_string(NUM_THREADS) +
+                    ",divisor=" + to_string(DIVISOR) + ",native=" + (NATIVE_BUILD ? "on" : "off");
+    long long now = chrono::duration_cast<chrono::seconds>(chrono::system_clock::now().time_since_epoch()).count();
+
+    vector<HistoryEntry> current = {
+        measureForHistory("sequential", repeats, [&] {
+            int count = 0, minElement = 0;
+            findDivisibleWithoutParallel(data, count, minElement);
+            keepAlive(count + minElement);
+        }),
+        measureForHistory("mutex", repeats, [&] {
+            int count = 0, minElement = 0;
+            findDivisibleWithMutex(data, count, minElement);
+            keepAlive(count + minElement);
+        }),
+        measureForHistory("atomic", repeats, [&] {
+            atomic atomicCount(0);
+            atomic atomicMinElement(INT_MAX);
+            findDivisibleWithAtomic(data, atomicCount, atomicMinElement);
+            keepAlive(atomicCount.load() + atomicMinElement.load());
+        }),
+    };
+
+    vector<HistoryEntry> history = loadHistory(path);
+    vector<string> regressed;
+    cout << "[*] Benchmark history (" << path << ", host " << host << ", " << config << ")\n";
+    for (auto& entry : current) {
+        entry.timestamp = now;
+        entry.host = host;
+        entry.config = config;
+
+        vector<double> medians;
+        vector<double> spreads;
+        for (const auto& past : history) {
+            if (past.host == host && past.config == config && past.strategy == entry.strategy) {
+                medians.push_back(past.median);
+                spreads.push_back(past.spread);
+            }
+        }
+        cout << entry.strategy << ": median " << entry.median << " s, spread " << entry.spread * 100 << "%";
+        if (medians.empty()) {
+            cout << ", no baseline yet" << endl;
+            continue;
+        }
+        double baseline = medianOf(medians);
+        // Median, like the baseline time, so one noisy past run cannot widen the threshold for good
+        double baselineSpread = medianOf(spreads);
+        double threshold = max(minThreshold, 3 * (entry.spread + baselineSpread));
+        double change = entry.median / baseline - 1;
+        cout << ", baseline " << baseline << " s (" << medians.size() << " runs), change " << change * 100
+             << "%, threshold " << threshold * 100 << "%";
+        if (change > threshold) {
+            cout << " REGRESSED";
+            regressed.push_back(entry.strategy);
+        }
+        cout << endl;
+    }
+
+    ofstream file(path, ios::app);
+    for (const auto& entry : current) {
+        file << entry.timestamp << '\t' << entry.host << '\t' << entry.config << '\t' << entry.strategy << '\t'
+             << entry.median << '\t' << entry.spread << '\n';
+    }
+
+    if (!regressed.empty()) {
+        cerr << "Performance regression in:";
+        for (const auto& strategy : regressed) {
+            cerr << " " << strategy;
+        }
+        cerr << endl;
+        return 2;
+    }
+    return 0;
+}
+
+// Driver flags of the form --name=value, removed from argv before the positional arguments are read
+struct DriverFlags {
+    string traceFile;
+    string jsonFile;
+    bool roofline = false;
+};
+
+DriverFlags parseDriverFlags(int& argc, char* argv[]) {
+    DriverFlags flags;
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg.rfind("--trace=", 0) == 0) {
+            flags.traceFile = arg.substr(8);
+        } else if (arg.rfind("--json=", 0) == 0) {
+            flags.jsonFile = arg.substr(7);
+        } else if (arg == "--roofline") {
+            flags.roofline = true;
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+    return flags;
+}
+
+int runMode(int argc, char* argv[]);
+
+int main(int argc, char* argv[]) {
+    DriverFlags flags = parseDriverFlags(argc, argv);
+    tracingEnabled = !flags.traceFile.empty();
+    rooflineEnabled = flags.roofline;
+
+    int status = runMode(argc, argv);
+
+    if (!flags.jsonFile.empty()) {
+        if (writeJsonResults(flags.jsonFile)) {
+            cout << "Results written to " << flags.jsonFile << endl;
+        } else {
+            cerr << "Failed to write results to " << flags.jsonFile << endl;
+        }
+    }
+
+    if (tracingEnabled) {
+        if (writeChromeTrace(flags.traceFile)) {
+            cout << "Trace written to " << flags.traceFile << endl;
+        } else {
+            cerr << "Failed to write trace to " << flags.traceFile << endl;
+        }
+    }
+    return status;
+}
+
+int runMode(int argc, char* argv[]) {
+    string mode = argc > 1 ? argv[1] : "";
+
+    if (mode == "snapshot") {
+        size_t size = argc > 2 ? stoull(argv[2]) : 1 << 24;
+        int durationMs = argc > 3 ? stoi(argv[3]) : 2000;
+        int writeIntervalUs = argc > 4 ? stoi(argv[4]) : 100;
+        runSnapshotBenchmark(size, durationMs, writeIntervalUs);
+        return 0;
+    }
+
+    if (mode == "distributions") {
+        int size = argc > 2 ? stoi(argv[2]) : 1 << 26;
+        GeneratorOptions options;
+        options.selectivity = argc > 3 ? stod(argv[3]) : options.selectivity;
+        for (const auto& [name, distribution] : DISTRIBUTIONS) {
+            options.distribution = distribution;
+            cout << "=== Distribution: " << name << " ===\n";
+            runStrategies(generateDataWithReport(size, options), name);
+        }
+        return 0;
+    }
+
+    if (mode == "sorted") {
+        int size = argc > 2 ? stoi(argv[2]) : 1 << 26;
+        int low = argc > 3 ? stoi(argv[3]) : 40000;
+        int high = argc > 4 ? stoi(argv[4]) : 41000;
+        runSortedBenchmark(size, low, high);
+        return 0;
+    }
+
+    if (mode == "topk") {
+        runTopKBenchmark(argc > 2 ? stoi(argv[2]) : 1 << 26);
+        return 0;
+    }
+
+    if (mode == "select") {
+        runSelectionBenchmark(argc > 2 ? stoi(argv[2]) : 1 << 26);
+        return 0;
+    }
+
+    if (mode == "residues") {
+        // Without a divisor, compare the vectorised kernel at its largest divisor with DIVISOR,
+        // which only the generic path handles
+        vector<int> divisors = {MAX_FIXED_RESIDUE_DIVISOR, DIVISOR};
+        if (argc > 2) {
+            divisors = {stoi(argv[2])};
+        }
+        if (divisors[0] <= 0) {
+            cerr << "Divisor must be positive" << endl;
+            return 1;
+        }
+        for (int d : divisors) {
+            runResidueBenchmark(d, argc > 3 ? stoi(argv[3]) : 1 << 26);
+        }
+        return 0;
+    }
+
+    if (mode == "window") {
+        int window = argc > 2 ? stoi(argv[2]) : 1 << 16;
+        int arrivals = argc > 3 ? stoi(argv[3]) : 1 << 24;
+        int batchSize = argc > 4 ? stoi(argv[4]) : 4096;
+        if (window <= 0 || batchSize <= 0) {
+            cerr << "Window and batch size must be positive" << endl;
+            return 1;
+        }
+        runWindowBenchmark(window, arrivals, batchSize);
+        return 0;
+    }
+
+    if (mode == "segments") {
+        int segments = argc > 2 ? stoi(argv[2]) : 1 << 20;
+        int averageLength = argc > 3 ? stoi(argv[3]) : 500;
+        runSegmentedBenchmark(segments, averageLength);
+        return 0;
+    }
+
+    if (mode == "wakeup") {
+        int size = argc > 2 ? stoi(argv[2]) : 4096;
+        int iterations = argc > 3 ? stoi(argv[3]) : 10000;
+        runWakeupBenchmark(size, max(1, iterations));
+        return 0;
+    }
+
+    if (mode == "sweep") {
+        size_t maxBytes = argc > 2 ? stoull(argv[2]) : 1ull << 30;
+        size_t minElements = argc > 3 ? stoull(argv[3]) : 1ull << 27;
+        runSweep(maxBytes, minElements, argc > 4 ? argv[4] : "");
+        return 0;
+    }
+
+    if (mode == "serve") {
+        if (argc < 3) {
+            cerr << "Usage: serve <metrics file | :port> [size] [sequential|mutex|atomic] [interval ms] [seconds]"
+                 << endl;
+            return 1;
+        }
+        int size = argc > 3 ? stoi(argv[3]) : 1 << 24;
+        string strategy = argc > 4 ? argv[4] : "mutex";
+        int intervalMs = argc > 5 ? stoi(argv[5]) : 5000;
+        int seconds = argc > 6 ? stoi(argv[6]) : 0;
+        return runServe(argv[2], size, strategy, max(10, intervalMs), seconds);
+    }
+
+    if (mode == "history") {
+        if (argc < 3) {
+            cerr << "Usage: history <file> [size] [repeats] [min threshold]" << endl;
+            return 1;
+        }
+        int size = argc > 3 ? stoi(argv[3]) : 1 << 24;
+        int repeats = argc > 4 ? stoi(argv[4]) : 15;
+        double minThreshold = argc > 5 ? stod(argv[5]) : 0.05;
+        return runHistoryCheck(argv[2], size, max(3, repeats), minThreshold);
+    }
+
+    if (mode == "file") {
+        if (argc < 3) {
+            cerr << "Usage: file <path> [elements to generate, 0 keeps the file] [block KB] [reads in flight]" << endl;
+            return 1;
+        }
+        int size = argc > 3 ? stoi(argv[3]) : 0;
+        size_t blockKb = argc > 4 ? stoull(argv[4]) : 1024;
+        int queueDepth = argc > 5 ? stoi(argv[5]) : 4;
+        // O_DIRECT transfers must be multiples of the alignment
+        size_t blockSize = max<size_t>(1, (blockKb * 1024 + DIRECT_IO_ALIGNMENT - 1) / DIRECT_IO_ALIGNMENT)
+                           * DIRECT_IO_ALIGNMENT;
+        return runFileBenchmark(argv[2], size, blockSize, max(1, queueDepth));
+    }
+
+    if (mode == "shards") {
+        if (argc < 3) {
+            cerr << "Usage: shards <directory of *" << SHARD_EXTENSION
+                 << " files | manifest> [shards to generate] [average elements per shard]" << endl;
+            return 1;
+        }
+        int shardCount = argc > 3 ? stoi(argv[3]) : 0;
+        int averageSize = argc > 4 ? stoi(argv[4]) : 1 << 20;
+        return runShardBenchmark(argv[2], shardCount, averageSize);
+    }
+
+    if (mode == "latency") {
+        int size = argc > 2 ? stoi(argv[2]) : 1 << 16;
+        int calls = argc > 3 ? stoi(argv[3]) : 10000;
+        int callers = argc > 4 ? stoi(argv[4]) : 1;
+        runLatencyBenchmark(size, max(1, calls), max(1, callers));
+        return 0;
+    }
+
+    if (mode == "adaptive") {
+        int size = argc > 2 ? stoi(argv[2]) : 1 << 28;
+        int maxWorkers = argc > 3 ? stoi(argv[3]) : max(NUM_THREADS, static_cast<int>(thread::hardware_concurrency()));
+        runAdaptiveBenchmark(size, max(1, maxWorkers));
+        return 0;
+    }
+
+    // Optional distribution name for the default run, e.g. "zipf" or "selectivity 0.5"
+    GeneratorOptions options;
+    if (!mode.empty() && !parseDistribution(mode, options.distribution)) {
+        cerr << "Unknown mode or distribution: " << mode << endl;
+        return 1;
+    }
+    options.selectivity = argc > 2 ? stod(argv[2]) : options.selectivity;
+
+    vector<int> data = generateDataWithReport(DATA_SIZE, options);
+    runStrategies(data, mode.empty() ? "uniform" : mode);
 
     return 0;
 }